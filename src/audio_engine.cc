@@ -1,38 +1,84 @@
 #include "audio_engine.h"
 
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
-#include <mutex>
+#include <atomic>
+#include <new>
 
 #include <SDL.h>
 
 namespace fallout {
 
-#define AUDIO_ENGINE_SOUND_BUFFERS 8
+// Number of bits of sound buffer handle used for slot index, the rest is
+// slot generation (see [audioEngineCreateSoundBuffer]).
+#define AUDIO_ENGINE_SLOT_BITS 8
+#define AUDIO_ENGINE_SLOT_MASK ((1 << AUDIO_ENGINE_SLOT_BITS) - 1)
+#define AUDIO_ENGINE_GENERATION_MASK (INT_MAX >> AUDIO_ENGINE_SLOT_BITS)
 
+// Maximum number of bytes kept by released sound buffers for reuse.
+#define AUDIO_ENGINE_POOL_MAX_SIZE (4 * 1024 * 1024)
+
+// Sound buffers are created and released with audio device locked, so mixer
+// never sees half-initialized buffer. Playback state is shared with mixer
+// via atomics, so it never waits on the game thread.
 struct AudioEngineSoundBuffer {
-    bool active;
+    std::atomic<bool> active;
     unsigned int size;
     int bitsPerSample;
     int channels;
     int rate;
     void* data;
-    int volume;
-    bool playing;
-    bool looping;
-    unsigned int pos;
+    std::atomic<int> volume;
+    std::atomic<bool> playing;
+
+    // Set by mixer when buffer played to the end, stopped (paused) and not yet
+    // played buffers are not ended.
+    std::atomic<bool> ended;
+
+    std::atomic<bool> looping;
+    std::atomic<unsigned int> pos;
     SDL_AudioStream* stream;
-    std::recursive_mutex mutex;
+
+    // Allocated size of `data`, can be larger than `size` when buffer is
+    // reused. Released buffers keep `data` and `stream` for reuse.
+    unsigned int capacity;
+
+    // Incremented every time slot is handed out, so handles to released or
+    // stolen buffers are rejected.
+    int generation;
+
+    int priority;
+
+    // Creation order, the oldest voice is stolen first.
+    unsigned int sequence;
 };
 
 extern bool GNW95_isActive;
 
 static bool soundBufferIsValid(int soundBufferIndex);
 static void audioEngineMixin(void* userData, Uint8* stream, int length);
+static int audioEngineFeedSoundBuffer(AudioEngineSoundBuffer* soundBuffer, int length);
+static int audioEngineFindSoundBufferSlot(unsigned int size, int bitsPerSample, int channels, int rate, int priority);
+static void audioEngineSoundBufferFreeStorage(AudioEngineSoundBuffer* soundBuffer);
 
 static SDL_AudioSpec gAudioEngineSpec;
 static SDL_AudioDeviceID gAudioEngineDeviceId = -1;
-static AudioEngineSoundBuffer gAudioEngineSoundBuffers[AUDIO_ENGINE_SOUND_BUFFERS];
+static AudioEngineSoundBuffer* gAudioEngineSoundBuffers = NULL;
+static int gAudioEngineSoundBuffersCount = 0;
+
+// Number of voices to allocate on the next [audioEngineInit].
+static int gAudioEngineMaxSoundBuffers = AUDIO_ENGINE_DEFAULT_SOUND_BUFFERS;
+
+// Total capacity of data kept by released sound buffers.
+static unsigned int gAudioEnginePoolSize = 0;
+
+static unsigned int gAudioEngineNextSequence = 0;
+
+// Converted samples of one sound buffer before they are mixed in.
+static unsigned char* gAudioEngineMixBuffer = NULL;
+static int gAudioEngineMixBufferSize = 0;
 
 static bool audioEngineIsInitialized()
 {
@@ -41,7 +87,16 @@ static bool audioEngineIsInitialized()
 
 static bool soundBufferIsValid(int soundBufferIndex)
 {
-    return soundBufferIndex >= 0 && soundBufferIndex < AUDIO_ENGINE_SOUND_BUFFERS;
+    if (soundBufferIndex < 0) {
+        return false;
+    }
+
+    int slot = soundBufferIndex & AUDIO_ENGINE_SLOT_MASK;
+    if (slot >= gAudioEngineSoundBuffersCount) {
+        return false;
+    }
+
+    return gAudioEngineSoundBuffers[slot].generation == (soundBufferIndex >> AUDIO_ENGINE_SLOT_BITS);
 }
 
 static void audioEngineMixin(void* userData, Uint8* stream, int length)
@@ -52,45 +107,105 @@ static void audioEngineMixin(void* userData, Uint8* stream, int length)
         return;
     }
 
-    for (int index = 0; index < AUDIO_ENGINE_SOUND_BUFFERS; index++) {
+    for (int index = 0; index < gAudioEngineSoundBuffersCount; index++) {
         AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[index]);
-        std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+        if (!soundBuffer->active || !soundBuffer->playing) {
+            continue;
+        }
 
-        if (soundBuffer->active && soundBuffer->playing) {
-            int srcFrameSize = soundBuffer->bitsPerSample / 8 * soundBuffer->channels;
+        int pos = 0;
+        while (pos < length) {
+            int remaining = length - pos;
+            if (remaining > gAudioEngineMixBufferSize) {
+                remaining = gAudioEngineMixBufferSize;
+            }
 
-            unsigned char buffer[1024];
-            int pos = 0;
-            while (pos < length) {
-                int remaining = length - pos;
-                if (remaining > sizeof(buffer)) {
-                    remaining = sizeof(buffer);
-                }
+            bool reachedEnd = audioEngineFeedSoundBuffer(soundBuffer, remaining) == -1;
 
-                // TODO: Make something better than frame-by-frame convertion.
-                SDL_AudioStreamPut(soundBuffer->stream, (unsigned char*)soundBuffer->data + soundBuffer->pos, srcFrameSize);
-                soundBuffer->pos += srcFrameSize;
+            int bytesRead = SDL_AudioStreamGet(soundBuffer->stream, gAudioEngineMixBuffer, remaining);
+            if (bytesRead > 0) {
+                SDL_MixAudioFormat(stream + pos, gAudioEngineMixBuffer, gAudioEngineSpec.format, bytesRead, soundBuffer->volume);
+            }
 
-                int bytesRead = SDL_AudioStreamGet(soundBuffer->stream, buffer, remaining);
-                if (bytesRead == -1) {
-                    break;
-                }
+            if (reachedEnd && SDL_AudioStreamAvailable(soundBuffer->stream) == 0) {
+                soundBuffer->playing = false;
+                soundBuffer->ended = true;
+                break;
+            }
 
-                SDL_MixAudioFormat(stream + pos, buffer, gAudioEngineSpec.format, bytesRead, soundBuffer->volume);
+            if (bytesRead <= 0) {
+                break;
+            }
 
-                if (soundBuffer->pos >= soundBuffer->size) {
-                    if (soundBuffer->looping) {
-                        soundBuffer->pos %= soundBuffer->size;
-                    } else {
-                        soundBuffer->playing = false;
-                        break;
-                    }
-                }
+            pos += bytesRead;
+        }
+    }
+}
 
-                pos += bytesRead;
+// Puts enough source data into sound buffer stream to produce `length`
+// bytes of output. Contiguous spans are converted at once, wrapping around
+// end of looping buffer. Returns -1 when non-looping buffer is exhausted.
+static int audioEngineFeedSoundBuffer(AudioEngineSoundBuffer* soundBuffer, int length)
+{
+    // Game thread may reposition buffer while we convert, its position wins.
+    unsigned int startPos = soundBuffer->pos;
+    if (startPos >= soundBuffer->size && !soundBuffer->looping) {
+        return -1;
+    }
+
+    int available = SDL_AudioStreamAvailable(soundBuffer->stream);
+    if (available >= length) {
+        return 0;
+    }
+
+    int destFrameSize = SDL_AUDIO_BITSIZE(gAudioEngineSpec.format) / 8 * gAudioEngineSpec.channels;
+    int srcFrameSize = soundBuffer->bitsPerSample / 8 * soundBuffer->channels;
+
+    // One extra frame on both sides covers resampler rounding.
+    long long destFrames = (length - available) / destFrameSize + 1;
+    unsigned int srcBytes = (unsigned int)((destFrames * soundBuffer->rate / gAudioEngineSpec.freq + 1) * srcFrameSize);
+
+    unsigned int pos = startPos % soundBuffer->size;
+    int rc = 0;
+
+    while (srcBytes > 0) {
+        unsigned int span = soundBuffer->size - pos;
+        if (span > srcBytes) {
+            span = srcBytes;
+        }
+
+        SDL_AudioStreamPut(soundBuffer->stream, (unsigned char*)soundBuffer->data + pos, span);
+        pos += span;
+        srcBytes -= span;
+
+        if (pos >= soundBuffer->size) {
+            if (soundBuffer->looping) {
+                pos = 0;
+            } else {
+                SDL_AudioStreamFlush(soundBuffer->stream);
+                rc = -1;
+                break;
             }
         }
     }
+
+    soundBuffer->pos.compare_exchange_strong(startPos, pos);
+
+    return rc;
+}
+
+// Sets number of voices allocated by the next [audioEngineInit].
+void audioEngineSetMaxSoundBuffers(int count)
+{
+    if (count < 1) {
+        count = 1;
+    }
+
+    if (count > AUDIO_ENGINE_MAX_SOUND_BUFFERS) {
+        count = AUDIO_ENGINE_MAX_SOUND_BUFFERS;
+    }
+
+    gAudioEngineMaxSoundBuffers = count;
 }
 
 bool audioEngineInit()
@@ -99,6 +214,14 @@ bool audioEngineInit()
         return false;
     }
 
+    gAudioEngineSoundBuffers = new (std::nothrow) AudioEngineSoundBuffer[gAudioEngineMaxSoundBuffers]();
+    if (gAudioEngineSoundBuffers == NULL) {
+        return false;
+    }
+
+    gAudioEngineSoundBuffersCount = gAudioEngineMaxSoundBuffers;
+    gAudioEnginePoolSize = 0;
+
     SDL_AudioSpec desiredSpec;
     desiredSpec.freq = 22050;
     desiredSpec.format = AUDIO_S16;
@@ -111,6 +234,14 @@ bool audioEngineInit()
         return false;
     }
 
+    gAudioEngineMixBufferSize = gAudioEngineSpec.size;
+    gAudioEngineMixBuffer = (unsigned char*)malloc(gAudioEngineMixBufferSize);
+    if (gAudioEngineMixBuffer == NULL) {
+        SDL_CloseAudioDevice(gAudioEngineDeviceId);
+        gAudioEngineDeviceId = -1;
+        return false;
+    }
+
     SDL_PauseAudioDevice(gAudioEngineDeviceId, 0);
 
     return true;
@@ -123,6 +254,24 @@ void audioEngineExit()
         gAudioEngineDeviceId = -1;
     }
 
+    if (gAudioEngineMixBuffer != NULL) {
+        free(gAudioEngineMixBuffer);
+        gAudioEngineMixBuffer = NULL;
+        gAudioEngineMixBufferSize = 0;
+    }
+
+    if (gAudioEngineSoundBuffers != NULL) {
+        for (int index = 0; index < gAudioEngineSoundBuffersCount; index++) {
+            audioEngineSoundBufferFreeStorage(&(gAudioEngineSoundBuffers[index]));
+        }
+
+        delete[] gAudioEngineSoundBuffers;
+        gAudioEngineSoundBuffers = NULL;
+        gAudioEngineSoundBuffersCount = 0;
+    }
+
+    gAudioEnginePoolSize = 0;
+
     if (SDL_WasInit(SDL_INIT_AUDIO)) {
         SDL_QuitSubSystem(SDL_INIT_AUDIO);
     }
@@ -142,33 +291,73 @@ void audioEngineResume()
     }
 }
 
-int audioEngineCreateSoundBuffer(unsigned int size, int bitsPerSample, int channels, int rate)
+// Returns handle of new sound buffer. When all voices are in use, a stopped
+// voice or a voice with lower `priority` is stolen. Handles to stolen voices
+// report them as finished.
+int audioEngineCreateSoundBuffer(unsigned int size, int bitsPerSample, int channels, int rate, int priority)
 {
     if (!audioEngineIsInitialized()) {
         return -1;
     }
 
-    for (int index = 0; index < AUDIO_ENGINE_SOUND_BUFFERS; index++) {
-        AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[index]);
-        std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
-
-        if (!soundBuffer->active) {
-            soundBuffer->active = true;
-            soundBuffer->size = size;
-            soundBuffer->bitsPerSample = bitsPerSample;
-            soundBuffer->channels = channels;
-            soundBuffer->rate = rate;
-            soundBuffer->volume = SDL_MIX_MAXVOLUME;
-            soundBuffer->playing = false;
-            soundBuffer->looping = false;
-            soundBuffer->pos = 0;
-            soundBuffer->data = malloc(size);
-            soundBuffer->stream = SDL_NewAudioStream(bitsPerSample == 16 ? AUDIO_S16 : AUDIO_S8, channels, rate, gAudioEngineSpec.format, gAudioEngineSpec.channels, gAudioEngineSpec.freq);
-            return index;
+    int slot = audioEngineFindSoundBufferSlot(size, bitsPerSample, channels, rate, priority);
+    if (slot == -1) {
+        return -1;
+    }
+
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[slot]);
+
+    SDL_LockAudioDevice(gAudioEngineDeviceId);
+
+    if (soundBuffer->active) {
+        soundBuffer->active = false;
+    } else {
+        gAudioEnginePoolSize -= soundBuffer->capacity;
+    }
+
+    if (soundBuffer->capacity < size) {
+        free(soundBuffer->data);
+        soundBuffer->data = malloc(size);
+        soundBuffer->capacity = soundBuffer->data != NULL ? size : 0;
+    }
+
+    if (soundBuffer->stream != NULL
+        && soundBuffer->bitsPerSample == bitsPerSample
+        && soundBuffer->channels == channels
+        && soundBuffer->rate == rate) {
+        SDL_AudioStreamClear(soundBuffer->stream);
+    } else {
+        if (soundBuffer->stream != NULL) {
+            SDL_FreeAudioStream(soundBuffer->stream);
         }
+
+        soundBuffer->stream = SDL_NewAudioStream(bitsPerSample == 16 ? AUDIO_S16 : AUDIO_S8, channels, rate, gAudioEngineSpec.format, gAudioEngineSpec.channels, gAudioEngineSpec.freq);
     }
 
-    return -1;
+    soundBuffer->size = size;
+    soundBuffer->bitsPerSample = bitsPerSample;
+    soundBuffer->channels = channels;
+    soundBuffer->rate = rate;
+    soundBuffer->volume = SDL_MIX_MAXVOLUME;
+    soundBuffer->playing = false;
+    soundBuffer->ended = false;
+    soundBuffer->looping = false;
+    soundBuffer->pos = 0;
+    soundBuffer->priority = priority;
+    soundBuffer->sequence = gAudioEngineNextSequence++;
+    soundBuffer->generation = (soundBuffer->generation + 1) & AUDIO_ENGINE_GENERATION_MASK;
+
+    if (soundBuffer->data == NULL || soundBuffer->stream == NULL) {
+        audioEngineSoundBufferFreeStorage(soundBuffer);
+        SDL_UnlockAudioDevice(gAudioEngineDeviceId);
+        return -1;
+    }
+
+    soundBuffer->active = true;
+
+    SDL_UnlockAudioDevice(gAudioEngineDeviceId);
+
+    return (soundBuffer->generation << AUDIO_ENGINE_SLOT_BITS) | slot;
 }
 
 bool audioEngineSoundBufferRelease(int soundBufferIndex)
@@ -181,20 +370,25 @@ bool audioEngineSoundBufferRelease(int soundBufferIndex)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
     }
 
+    SDL_LockAudioDevice(gAudioEngineDeviceId);
+
     soundBuffer->active = false;
+    soundBuffer->playing = false;
 
-    free(soundBuffer->data);
-    soundBuffer->data = NULL;
+    // Keep storage for the next sound buffer unless pool is full.
+    if (gAudioEnginePoolSize + soundBuffer->capacity <= AUDIO_ENGINE_POOL_MAX_SIZE) {
+        gAudioEnginePoolSize += soundBuffer->capacity;
+    } else {
+        audioEngineSoundBufferFreeStorage(soundBuffer);
+    }
 
-    SDL_FreeAudioStream(soundBuffer->stream);
-    soundBuffer->stream = NULL;
+    SDL_UnlockAudioDevice(gAudioEngineDeviceId);
 
     return true;
 }
@@ -209,8 +403,7 @@ bool audioEngineSoundBufferSetVolume(int soundBufferIndex, int volume)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -231,8 +424,7 @@ bool audioEngineSoundBufferGetVolume(int soundBufferIndex, int* volumePtr)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -253,8 +445,7 @@ bool audioEngineSoundBufferSetPan(int soundBufferIndex, int pan)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -276,13 +467,13 @@ bool audioEngineSoundBufferPlay(int soundBufferIndex, unsigned int flags)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
     }
 
+    soundBuffer->ended = false;
     soundBuffer->playing = true;
 
     if ((flags & AUDIO_ENGINE_SOUND_BUFFER_PLAY_LOOPING) != 0) {
@@ -302,8 +493,7 @@ bool audioEngineSoundBufferStop(int soundBufferIndex)
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -324,8 +514,7 @@ bool audioEngineSoundBufferGetCurrentPosition(int soundBufferIndex, unsigned int
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -359,8 +548,7 @@ bool audioEngineSoundBufferSetCurrentPosition(int soundBufferIndex, unsigned int
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -381,8 +569,7 @@ bool audioEngineSoundBufferLock(int soundBufferIndex, unsigned int writePos, uns
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -442,8 +629,7 @@ bool audioEngineSoundBufferUnlock(int soundBufferIndex, void* audioPtr1, unsigne
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -461,11 +647,16 @@ bool audioEngineSoundBufferGetStatus(int soundBufferIndex, unsigned int* statusP
     }
 
     if (!soundBufferIsValid(soundBufferIndex)) {
+        // Voice was stolen, report it as finished so owner cleans up.
+        if (soundBufferIndex >= 0 && (soundBufferIndex & AUDIO_ENGINE_SLOT_MASK) < gAudioEngineSoundBuffersCount && statusPtr != NULL) {
+            *statusPtr = 0;
+            return true;
+        }
+
         return false;
     }
 
-    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex]);
-    std::lock_guard<std::recursive_mutex> lock(soundBuffer->mutex);
+    AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[soundBufferIndex & AUDIO_ENGINE_SLOT_MASK]);
 
     if (!soundBuffer->active) {
         return false;
@@ -488,4 +679,86 @@ bool audioEngineSoundBufferGetStatus(int soundBufferIndex, unsigned int* statusP
     return true;
 }
 
+// Picks slot for new sound buffer, see [audioEngineCreateSoundBuffer].
+static int audioEngineFindSoundBufferSlot(unsigned int size, int bitsPerSample, int channels, int rate, int priority)
+{
+    // Prefer released slot which storage can be reused as is.
+    int best = -1;
+    int bestScore = -1;
+    for (int index = 0; index < gAudioEngineSoundBuffersCount; index++) {
+        AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[index]);
+        if (soundBuffer->active) {
+            continue;
+        }
+
+        int score = 0;
+        if (soundBuffer->capacity >= size) {
+            score += 2;
+        }
+
+        if (soundBuffer->stream != NULL
+            && soundBuffer->bitsPerSample == bitsPerSample
+            && soundBuffer->channels == channels
+            && soundBuffer->rate == rate) {
+            score += 1;
+        }
+
+        if (score > bestScore) {
+            best = index;
+            bestScore = score;
+        }
+    }
+
+    if (best != -1) {
+        return best;
+    }
+
+    // Steal voice which played to the end of the same or lower priority, or
+    // any other voice (playing, paused or not yet played) of lower priority.
+    // Ended, lower priority and older voices go first.
+    for (int index = 0; index < gAudioEngineSoundBuffersCount; index++) {
+        AudioEngineSoundBuffer* soundBuffer = &(gAudioEngineSoundBuffers[index]);
+        bool ended = soundBuffer->ended;
+
+        if (ended ? soundBuffer->priority > priority : soundBuffer->priority >= priority) {
+            continue;
+        }
+
+        if (best != -1) {
+            AudioEngineSoundBuffer* bestSoundBuffer = &(gAudioEngineSoundBuffers[best]);
+            bool bestEnded = bestSoundBuffer->ended;
+            if (ended != bestEnded) {
+                if (!ended) {
+                    continue;
+                }
+            } else if (soundBuffer->priority != bestSoundBuffer->priority) {
+                if (soundBuffer->priority > bestSoundBuffer->priority) {
+                    continue;
+                }
+            } else if ((int)(soundBuffer->sequence - bestSoundBuffer->sequence) > 0) {
+                continue;
+            }
+        }
+
+        best = index;
+    }
+
+    return best;
+}
+
+static void audioEngineSoundBufferFreeStorage(AudioEngineSoundBuffer* soundBuffer)
+{
+    if (soundBuffer->data != NULL) {
+        free(soundBuffer->data);
+        soundBuffer->data = NULL;
+    }
+
+    if (soundBuffer->stream != NULL) {
+        SDL_FreeAudioStream(soundBuffer->stream);
+        soundBuffer->stream = NULL;
+    }
+
+    soundBuffer->capacity = 0;
+}
+
 } // namespace fallout
@@ -11,11 +11,23 @@ namespace fallout {
 #define AUDIO_ENGINE_SOUND_BUFFER_STATUS_PLAYING 0x00000001
 #define AUDIO_ENGINE_SOUND_BUFFER_STATUS_LOOPING 0x00000004
 
+// Default and maximum number of simultaneously allocated sound buffers
+// (voices).
+#define AUDIO_ENGINE_DEFAULT_SOUND_BUFFERS 32
+#define AUDIO_ENGINE_MAX_SOUND_BUFFERS 256
+
+// Voice priorities, when all voices are in use new sound buffer can steal
+// voice of lower priority.
+#define AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_LOW 0
+#define AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_NORMAL 1
+#define AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_HIGH 2
+
+void audioEngineSetMaxSoundBuffers(int count);
 bool audioEngineInit();
 void audioEngineExit();
 void audioEnginePause();
 void audioEngineResume();
-int audioEngineCreateSoundBuffer(unsigned int size, int bitsPerSample, int channels, int rate);
+int audioEngineCreateSoundBuffer(unsigned int size, int bitsPerSample, int channels, int rate, int priority = AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_NORMAL);
 bool audioEngineSoundBufferRelease(int soundBufferIndex);
 bool audioEngineSoundBufferSetVolume(int soundBufferIndex, int volume);
 bool audioEngineSoundBufferGetVolume(int soundBufferIndex, int* volumePtr);
@@ -7,6 +7,7 @@ namespace fallout {
 FpsLimiter::FpsLimiter(unsigned int fps)
     : _fps(fps)
     , _ticks(0)
+    , _enabled(true)
 {
 }
 
@@ -17,9 +18,18 @@ void FpsLimiter::mark()
 
 void FpsLimiter::throttle() const
 {
+    if (!_enabled) {
+        return;
+    }
+
     if (1000 / _fps > SDL_GetTicks() - _ticks) {
         SDL_Delay(1000 / _fps - (SDL_GetTicks() - _ticks));
     }
 }
 
+void FpsLimiter::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
 } // namespace fallout
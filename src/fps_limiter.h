@@ -8,10 +8,12 @@ public:
     FpsLimiter(unsigned int fps = 60);
     void mark();
     void throttle() const;
+    void setEnabled(bool enabled);
 
 private:
     const unsigned int _fps;
     unsigned int _ticks;
+    bool _enabled;
 };
 
 } // namespace fallout
@@ -39,6 +39,8 @@ namespace fallout {
 #define ANIMATION_DESCRIPTION_LIST_CAPACITY 40
 #define ANIMATION_SAD_LIST_CAPACITY 16
 
+#define PATH_NODE_LIST_CAPACITY 2000
+
 #define ANIMATION_SEQUENCE_FORCED 0x01
 
 typedef enum AnimationKind {
@@ -268,6 +270,11 @@ static int anim_animate(Object* obj, int anim, int animationSequenceIndex, int f
 static void object_anim_compact();
 static int anim_turn_towards(Object* obj, int delta, int animationSequenceIndex);
 static int check_gravity(int tile, int elevation);
+static bool path_node_cost_less(int a, int b);
+static bool path_slot_less(int a, int b);
+static void path_heap_push(short* heap, int* lengthPtr, int value, bool (*less)(int, int));
+static int path_heap_pop(short* heap, int* lengthPtr, bool (*less)(int, int));
+static int path_alloc_slot();
 
 // 0x4FEA98
 static int curr_sad = 0;
@@ -288,7 +295,7 @@ static bool anim_in_bk = false;
 static AnimationSad sad[ANIMATION_SAD_LIST_CAPACITY];
 
 // 0x5566D4
-static PathNode dad[2000];
+static PathNode dad[PATH_NODE_LIST_CAPACITY];
 
 // 0x560314
 static AnimationSequence anim_set[ANIMATION_SEQUENCE_LIST_CAPACITY];
@@ -297,7 +304,31 @@ static AnimationSequence anim_set[ANIMATION_SEQUENCE_LIST_CAPACITY];
 static unsigned char seen[5000];
 
 // 0x54CA94
-static PathNode child[2000];
+static PathNode child[PATH_NODE_LIST_CAPACITY];
+
+// Open list of [make_path_func] - binary min-heap of indexes into [child]
+// ordered by estimated path cost.
+static short child_heap[PATH_NODE_LIST_CAPACITY];
+
+// Number of elements in [child_heap].
+static int child_heap_length;
+
+// Min-heap of released slots in [child] below [child_next_slot].
+//
+// The original code placed new open nodes into the first unused slot of
+// [child] and broke cost ties by slot index. Reusing the lowest released slot
+// keeps this ordering, so resulting paths are identical.
+static short child_free_slots[PATH_NODE_LIST_CAPACITY];
+
+// Number of elements in [child_free_slots].
+static int child_free_slots_length;
+
+// First slot in [child] that was never used during current path search.
+static int child_next_slot;
+
+// Maps tile to its index in [dad]. Only valid for tiles which were closed
+// during current path search.
+static short dad_index[HEX_GRID_SIZE];
 
 // 0x56B56C
 static int curr_anim_counter;
@@ -1771,6 +1802,8 @@ int make_path(Object* object, int from, int to, unsigned char* rotations, int a5
 // 0x4159E8
 int make_path_func(Object* object, int from, int to, unsigned char* rotations, int a5, PathBuilderCallback* callback)
 {
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_PATHFINDING);
+
     if (a5) {
         if (callback(object, to, object->elevation) != NULL) {
             return 0;
@@ -1789,9 +1822,10 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
     child[0].field_C = EST(from, to);
     child[0].field_10 = 0;
 
-    for (int index = 1; index < 2000; index += 1) {
-        child[index].tile = -1;
-    }
+    child_heap_length = 0;
+    child_free_slots_length = 0;
+    child_next_slot = 1;
+    path_heap_push(child_heap, &child_heap_length, 0, path_node_cost_less);
 
     int toScreenX;
     int toScreenY;
@@ -1802,20 +1836,7 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
     PathNode temp;
 
     while (1) {
-        int v63 = -1;
-
-        PathNode* prev = NULL;
-        int v12 = 0;
-        for (int index = 0; v12 < openPathNodeListLength; index += 1) {
-            PathNode* curr = &(child[index]);
-            if (curr->tile != -1) {
-                v12++;
-                if (v63 == -1 || (curr->field_C + curr->field_10) < (prev->field_C + prev->field_10)) {
-                    prev = curr;
-                    v63 = index;
-                }
-            }
-        }
+        int v63 = path_heap_pop(child_heap, &child_heap_length, path_node_cost_less);
 
         PathNode* curr = &(child[v63]);
 
@@ -1824,6 +1845,7 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
         openPathNodeListLength -= 1;
 
         curr->tile = -1;
+        path_heap_push(child_free_slots, &child_free_slots_length, v63, path_slot_less);
 
         if (temp.tile == to) {
             if (openPathNodeListLength == 0) {
@@ -1835,9 +1857,11 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
         PathNode* curr1 = &(dad[closedPathNodeListLength]);
         memcpy(curr1, &temp, sizeof(temp));
 
+        dad_index[temp.tile] = closedPathNodeListLength;
+
         closedPathNodeListLength += 1;
 
-        if (closedPathNodeListLength == 2000) {
+        if (closedPathNodeListLength == PATH_NODE_LIST_CAPACITY) {
             return 0;
         }
 
@@ -1857,21 +1881,16 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
                 }
             }
 
-            int v25 = 0;
-            for (; v25 < 2000; v25++) {
-                if (child[v25].tile == -1) {
-                    break;
-                }
-            }
-
             openPathNodeListLength += 1;
 
-            if (openPathNodeListLength == 2000) {
+            if (openPathNodeListLength == PATH_NODE_LIST_CAPACITY) {
                 return 0;
             }
 
             seen[tile / 8] |= bit;
 
+            int v25 = path_alloc_slot();
+
             PathNode* v27 = &(child[v25]);
             v27->tile = tile;
             v27->from = temp.tile;
@@ -1887,6 +1906,8 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
             if (isNotInCombat && temp.rotation != rotation) {
                 v27->field_10 += 10;
             }
+
+            path_heap_push(child_heap, &child_heap_length, v25, path_node_cost_less);
         }
 
         if (openPathNodeListLength == 0) {
@@ -1907,12 +1928,7 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
                 v39 += 1;
             }
 
-            int j = 0;
-            while (dad[j].tile != temp.from) {
-                j++;
-            }
-
-            PathNode* v36 = &(dad[j]);
+            PathNode* v36 = &(dad[dad_index[temp.from]]);
             memcpy(&temp, v36, sizeof(temp));
         }
 
@@ -1938,6 +1954,87 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
     return 0;
 }
 
+// Returns `true` if open node in [child] slot `a` should be expanded before
+// node in slot `b`.
+static bool path_node_cost_less(int a, int b)
+{
+    int costA = child[a].field_C + child[a].field_10;
+    int costB = child[b].field_C + child[b].field_10;
+    if (costA != costB) {
+        return costA < costB;
+    }
+
+    return a < b;
+}
+
+static bool path_slot_less(int a, int b)
+{
+    return a < b;
+}
+
+static void path_heap_push(short* heap, int* lengthPtr, int value, bool (*less)(int, int))
+{
+    int index = *lengthPtr;
+    *lengthPtr += 1;
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!less(value, heap[parent])) {
+            break;
+        }
+
+        heap[index] = heap[parent];
+        index = parent;
+    }
+
+    heap[index] = value;
+}
+
+static int path_heap_pop(short* heap, int* lengthPtr, bool (*less)(int, int))
+{
+    int top = heap[0];
+
+    *lengthPtr -= 1;
+    int length = *lengthPtr;
+    if (length == 0) {
+        return top;
+    }
+
+    int value = heap[length];
+    int index = 0;
+    while (1) {
+        int childIndex = index * 2 + 1;
+        if (childIndex >= length) {
+            break;
+        }
+
+        if (childIndex + 1 < length && less(heap[childIndex + 1], heap[childIndex])) {
+            childIndex += 1;
+        }
+
+        if (!less(heap[childIndex], value)) {
+            break;
+        }
+
+        heap[index] = heap[childIndex];
+        index = childIndex;
+    }
+
+    heap[index] = value;
+
+    return top;
+}
+
+// Returns lowest unused slot in [child].
+static int path_alloc_slot()
+{
+    if (child_free_slots_length != 0) {
+        return path_heap_pop(child_free_slots, &child_free_slots_length, path_slot_less);
+    }
+
+    return child_next_slot++;
+}
+
 // 0x415D9C
 int idist(int x1, int y1, int x2, int y2)
 {
@@ -16,6 +16,12 @@
 
 namespace fallout {
 
+// Size of FRM header on disk (see [art_readFrameData]).
+#define ART_HEADER_SIZE 62
+
+// Size of frame header on disk (see [ArtFrame]).
+#define ART_FRAME_HEADER_SIZE 12
+
 typedef struct ArtListDescription {
     int flags;
     char dir[16];
@@ -23,8 +29,10 @@ typedef struct ArtListDescription {
     int fileNamesLength; // number of entries in list
 } ArtListDescription;
 
-static int art_readSubFrameData(unsigned char* data, DB_FILE* stream, int count);
 static int art_readFrameData(Art* art, DB_FILE* stream);
+static int art_readFrames(unsigned char* data, int size, DB_FILE* stream);
+static short artReadInt16(const unsigned char* ptr);
+static int artReadInt32(const unsigned char* ptr);
 static int art_writeSubFrameData(unsigned char* data, DB_FILE* stream, int count);
 static int art_writeFrameData(Art* art, DB_FILE* stream);
 static int artGetDataSize(Art* art);
@@ -1024,42 +1032,36 @@ out:
     return ((v10 << 28) & 0x70000000) | (objectType << 24) | ((animType << 16) & 0xFF0000) | ((a3 << 12) & 0xF000) | (frmId & 0xFFF);
 }
 
-// 0x4193A0
-static int art_readSubFrameData(unsigned char* data, DB_FILE* stream, int count, int* paddingPtr)
+// 0x41945C
+static int art_readFrameData(Art* art, DB_FILE* stream)
 {
-    unsigned char* ptr = data;
-    int padding = 0;
-    for (int index = 0; index < count; index++) {
-        ArtFrame* frame = (ArtFrame*)ptr;
+    // NOTE: Original code reads header field by field.
+    unsigned char header[ART_HEADER_SIZE];
+    if (db_fread(header, sizeof(header), 1, stream) != 1) return -1;
 
-        if (db_freadInt16(stream, &(frame->width)) == -1) return -1;
-        if (db_freadInt16(stream, &(frame->height)) == -1) return -1;
-        if (db_freadInt32(stream, &(frame->size)) == -1) return -1;
-        if (db_freadInt16(stream, &(frame->x)) == -1) return -1;
-        if (db_freadInt16(stream, &(frame->y)) == -1) return -1;
-        if (db_fread(ptr + sizeof(ArtFrame), frame->size, 1, stream) != 1) return -1;
+    unsigned char* ptr = header;
+    art->field_0 = artReadInt32(ptr);
+    art->framesPerSecond = artReadInt16(ptr + 4);
+    art->actionFrame = artReadInt16(ptr + 6);
+    art->frameCount = artReadInt16(ptr + 8);
+    ptr += 10;
 
-        ptr += sizeof(ArtFrame) + frame->size;
-        ptr += paddingForSize(frame->size);
-        padding += paddingForSize(frame->size);
+    for (int index = 0; index < ROTATION_COUNT; index++) {
+        art->xOffsets[index] = artReadInt16(ptr);
+        ptr += 2;
     }
 
-    *paddingPtr = padding;
+    for (int index = 0; index < ROTATION_COUNT; index++) {
+        art->yOffsets[index] = artReadInt16(ptr);
+        ptr += 2;
+    }
 
-    return 0;
-}
+    for (int index = 0; index < ROTATION_COUNT; index++) {
+        art->dataOffsets[index] = artReadInt32(ptr);
+        ptr += 4;
+    }
 
-// 0x41945C
-static int art_readFrameData(Art* art, DB_FILE* stream)
-{
-    if (db_freadInt32(stream, &(art->field_0)) == -1) return -1;
-    if (db_freadInt16(stream, &(art->framesPerSecond)) == -1) return -1;
-    if (db_freadInt16(stream, &(art->actionFrame)) == -1) return -1;
-    if (db_freadInt16(stream, &(art->frameCount)) == -1) return -1;
-    if (db_freadInt16List(stream, art->xOffsets, ROTATION_COUNT) == -1) return -1;
-    if (db_freadInt16List(stream, art->yOffsets, ROTATION_COUNT) == -1) return -1;
-    if (db_freadInt32List(stream, art->dataOffsets, ROTATION_COUNT) == -1) return -1;
-    if (db_freadInt32(stream, &(art->dataSize)) == -1) return -1;
+    art->dataSize = artReadInt32(ptr);
 
     return 0;
 }
@@ -1070,6 +1072,8 @@ Art* load_frame(const char* path)
     DB_FILE* stream;
     Art header;
 
+    // NOTE: Original code opens file twice - first to read header and
+    // calculate size, then once again in [load_frame_into].
     stream = db_fopen(path, "rb");
     if (stream == NULL) {
         return nullptr;
@@ -1080,18 +1084,23 @@ Art* load_frame(const char* path)
         return nullptr;
     }
 
-    db_fclose(stream);
-
-    unsigned char* data = reinterpret_cast<unsigned char*>(mem_malloc(artGetDataSize(&header)));
+    int size = artGetDataSize(&header);
+    unsigned char* data = reinterpret_cast<unsigned char*>(mem_malloc(size));
     if (data == NULL) {
+        db_fclose(stream);
         return nullptr;
     }
 
-    if (load_frame_into(path, data) != 0) {
+    memcpy(data, &header, sizeof(header));
+
+    if (art_readFrames(data, size, stream) != 0) {
+        db_fclose(stream);
         mem_free(data);
         return nullptr;
     }
 
+    db_fclose(stream);
+
     return reinterpret_cast<Art*>(data);
 }
 
@@ -1109,6 +1118,32 @@ int load_frame_into(const char* path, unsigned char* data)
         return -3;
     }
 
+    if (art_readFrames(data, artGetDataSize(art), stream) != 0) {
+        db_fclose(stream);
+        return -5;
+    }
+
+    db_fclose(stream);
+    return 0;
+}
+
+// Reads frames of all directions into [data] which is [size] bytes long and
+// starts with header already read by [art_readFrameData].
+//
+// Frames are read with a single read into the tail of [data] and then moved
+// into their final (padded) locations. Worst case padding accounted in
+// [artGetDataSize] guarantees frames never move past unread data.
+static int art_readFrames(unsigned char* data, int size, DB_FILE* stream)
+{
+    Art* art = (Art*)data;
+    if (art->dataSize < 0 || art->dataSize > size - (int)sizeof(Art)) {
+        return -1;
+    }
+
+    unsigned char* src = data + size - art->dataSize;
+    unsigned char* end = src + db_fread(src, 1, art->dataSize, stream);
+    unsigned char* limit = data + size;
+
     int currentPadding = paddingForSize(sizeof(Art));
     int previousPadding = 0;
 
@@ -1118,14 +1153,47 @@ int load_frame_into(const char* path, unsigned char* data)
         if (index == 0 || art->dataOffsets[index - 1] != art->dataOffsets[index]) {
             art->padding[index] += previousPadding;
             currentPadding += previousPadding;
-            if (art_readSubFrameData(data + sizeof(Art) + art->dataOffsets[index] + art->padding[index], stream, art->frameCount, &previousPadding) != 0) {
-                db_fclose(stream);
-                return -5;
+
+            if (art->dataOffsets[index] < 0) {
+                return -1;
             }
+
+            unsigned char* dest = data + sizeof(Art) + art->dataOffsets[index] + art->padding[index];
+            int padding = 0;
+            for (int frameIndex = 0; frameIndex < art->frameCount; frameIndex++) {
+                if (end - src < ART_FRAME_HEADER_SIZE) {
+                    return -1;
+                }
+
+                ArtFrame frame;
+                frame.width = artReadInt16(src);
+                frame.height = artReadInt16(src + 2);
+                frame.size = artReadInt32(src + 4);
+                frame.x = artReadInt16(src + 8);
+                frame.y = artReadInt16(src + 10);
+                src += ART_FRAME_HEADER_SIZE;
+
+                if (frame.size < 0 || end - src < frame.size) {
+                    return -1;
+                }
+
+                if (dest > src - sizeof(ArtFrame) || limit - dest < (int)sizeof(ArtFrame) + frame.size) {
+                    return -1;
+                }
+
+                memmove(dest + sizeof(ArtFrame), src, frame.size);
+                memcpy(dest, &frame, sizeof(ArtFrame));
+                src += frame.size;
+
+                dest += sizeof(ArtFrame) + frame.size;
+                dest += paddingForSize(frame.size);
+                padding += paddingForSize(frame.size);
+            }
+
+            previousPadding = padding;
         }
     }
 
-    db_fclose(stream);
     return 0;
 }
 
@@ -1216,4 +1284,14 @@ static int paddingForSize(int size)
     return (sizeof(int) - size % sizeof(int)) % sizeof(int);
 }
 
+static short artReadInt16(const unsigned char* ptr)
+{
+    return (short)((ptr[0] << 8) | ptr[1]);
+}
+
+static int artReadInt32(const unsigned char* ptr)
+{
+    return (int)(((unsigned int)ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3]);
+}
+
 } // namespace fallout
@@ -11,19 +11,22 @@
 
 namespace fallout {
 
-static bool cache_add(Cache* cache, int key, int* indexPtr);
-static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index);
-static int cache_find(Cache* cache, int key, int* indexPtr);
+static bool cache_add(Cache* cache, int key, CacheEntry** cacheEntryPtr);
+static bool cache_insert(Cache* cache, CacheEntry* cacheEntry);
+static CacheEntry* cache_find(Cache* cache, int key);
 static int cache_create_item(CacheEntry** cacheEntryPtr);
 static bool cache_init_item(CacheEntry* cacheEntry);
 static bool cache_destroy_item(Cache* cache, CacheEntry* cacheEntry);
 static bool cache_unlock_all(Cache* cache);
-static bool cache_reset_counter(Cache* cache);
 static bool cache_make_room(Cache* cache, int size);
 static bool cache_purge(Cache* cache);
 static bool cache_resize_array(Cache* cache, int newCapacity);
-static int cache_compare_make_room(const void* a1, const void* a2);
-static int cache_compare_reset_counter(const void* a1, const void* a2);
+static int cache_bucket_index(Cache* cache, int key);
+static bool cache_buckets_insert(Cache* cache, CacheEntry* cacheEntry);
+static void cache_buckets_remove(Cache* cache, CacheEntry* cacheEntry);
+static bool cache_resize_buckets(Cache* cache, int newCapacity);
+static void cache_lru_link(Cache* cache, CacheEntry* cacheEntry);
+static void cache_lru_unlink(Cache* cache, CacheEntry* cacheEntry);
 
 // 0x4FEC7C
 static int lock_sound_ticker = 0;
@@ -40,16 +43,23 @@ bool cache_init(Cache* cache, CacheSizeProc* sizeProc, CacheReadProc* readProc,
     cache->entriesLength = 0;
     cache->entriesCapacity = CACHE_ENTRIES_INITIAL_CAPACITY;
     cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
     cache->entries = (CacheEntry**)mem_malloc(sizeof(*cache->entries) * cache->entriesCapacity);
+    cache->bucketsCapacity = CACHE_BUCKETS_INITIAL_CAPACITY;
+    cache->buckets = (CacheEntry**)mem_malloc(sizeof(*cache->buckets) * cache->bucketsCapacity);
+    cache->lruHead = NULL;
+    cache->lruTail = NULL;
     cache->sizeProc = sizeProc;
     cache->readProc = readProc;
     cache->freeProc = freeProc;
 
-    if (cache->entries == NULL) {
+    if (cache->entries == NULL || cache->buckets == NULL) {
         return false;
     }
 
     memset(cache->entries, 0, sizeof(*cache->entries) * cache->entriesCapacity);
+    memset(cache->buckets, 0, sizeof(*cache->buckets) * cache->bucketsCapacity);
 
     return true;
 }
@@ -70,12 +80,23 @@ bool cache_exit(Cache* cache)
     cache->entriesLength = 0;
     cache->entriesCapacity = 0;
     cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
 
     if (cache->entries != NULL) {
         mem_free(cache->entries);
         cache->entries = NULL;
     }
 
+    if (cache->buckets != NULL) {
+        mem_free(cache->buckets);
+        cache->buckets = NULL;
+    }
+
+    cache->bucketsCapacity = 0;
+    cache->lruHead = NULL;
+    cache->lruTail = NULL;
+
     cache->sizeProc = NULL;
     cache->readProc = NULL;
     cache->freeProc = NULL;
@@ -86,13 +107,11 @@ bool cache_exit(Cache* cache)
 // 0x41EAC0
 int cache_query(Cache* cache, int key)
 {
-    int index;
-
     if (cache == NULL) {
         return 0;
     }
 
-    if (cache_find(cache, key, &index) != 2) {
+    if (cache_find(cache, key) == NULL) {
         return 0;
     }
 
@@ -108,31 +127,29 @@ bool cache_lock(Cache* cache, int key, void** data, CacheEntry** cacheEntryPtr)
 
     *cacheEntryPtr = NULL;
 
-    int index;
-    int rc = cache_find(cache, key, &index);
-    if (rc == 2) {
+    CacheEntry* cacheEntry = cache_find(cache, key);
+    if (cacheEntry != NULL) {
         // Use existing cache entry.
-        CacheEntry* cacheEntry = cache->entries[index];
         cacheEntry->hits++;
-    } else if (rc == 3) {
+        cache->hits++;
+    } else {
         // New cache entry is required.
         if (cache->entriesLength >= INT_MAX) {
             return false;
         }
 
-        if (!cache_add(cache, key, &index)) {
+        if (!cache_add(cache, key, &cacheEntry)) {
             return false;
         }
 
+        cache->misses++;
+
         lock_sound_ticker %= 4;
         if (lock_sound_ticker == 0) {
             soundUpdate();
         }
-    } else {
-        return false;
     }
 
-    CacheEntry* cacheEntry = cache->entries[index];
     if (cacheEntry->referenceCount == 0) {
         if (!heap_lock(&(cache->heap), cacheEntry->heapHandleIndex, &(cacheEntry->data))) {
             return false;
@@ -141,11 +158,10 @@ bool cache_lock(Cache* cache, int key, void** data, CacheEntry** cacheEntryPtr)
 
     cacheEntry->referenceCount++;
 
-    cache->hits++;
-    cacheEntry->mru = cache->hits;
-
-    if (cache->hits == UINT_MAX) {
-        cache_reset_counter(cache);
+    // Move entry to the head of recency list.
+    if (cache->lruHead != cacheEntry) {
+        cache_lru_unlink(cache, cacheEntry);
+        cache_lru_link(cache, cacheEntry);
     }
 
     *data = cacheEntry->data;
@@ -177,18 +193,17 @@ bool cache_unlock(Cache* cache, CacheEntry* cacheEntry)
 // 0x41EDEC
 int cache_discard(Cache* cache, int key)
 {
-    int index;
     CacheEntry* cacheEntry;
 
     if (cache == NULL) {
         return 0;
     }
 
-    if (cache_find(cache, key, &index) != 2) {
+    cacheEntry = cache_find(cache, key);
+    if (cacheEntry == NULL) {
         return 0;
     }
 
-    cacheEntry = cache->entries[index];
     if (cacheEntry->referenceCount != 0) {
         return 0;
     }
@@ -250,7 +265,17 @@ bool cache_stats(Cache* cache, char* dest, size_t size)
         return false;
     }
 
-    snprintf(dest, size, "Cache stats are disabled.%s", "\n");
+    unsigned int lookups = cache->hits + cache->misses;
+    snprintf(dest,
+        size,
+        "Cache stats:\n  Entries: %d\n  Size: %d of %d bytes\n  Hits: %u (%d%%)\n  Misses: %u\n  Evictions: %u\n",
+        cache->entriesLength,
+        cache->size,
+        cache->maxSize,
+        cache->hits,
+        lookups != 0 ? (int)((double)cache->hits * 100.0 / (double)lookups) : 0,
+        cache->misses,
+        cache->evictions);
 
     return true;
 }
@@ -358,7 +383,7 @@ int cache_destroy_list(int** tagsPtr)
 // Fetches entry for the specified key into the cache.
 //
 // 0x41F0AC
-static bool cache_add(Cache* cache, int key, int* indexPtr)
+static bool cache_add(Cache* cache, int key, CacheEntry** cacheEntryPtr)
 {
     CacheEntry* cacheEntry;
 
@@ -424,25 +449,12 @@ static bool cache_add(Cache* cache, int key, int* indexPtr)
             cacheEntry->size = size;
             cacheEntry->key = key;
 
-            bool isNewKey = true;
-            if (*indexPtr < cache->entriesLength) {
-                if (key < cache->entries[*indexPtr]->key) {
-                    if (*indexPtr == 0 || key > cache->entries[*indexPtr - 1]->key) {
-                        isNewKey = false;
-                    }
-                }
-            }
-
-            if (isNewKey) {
-                if (cache_find(cache, key, indexPtr) != 3) {
-                    break;
-                }
-            }
-
-            if (!cache_insert(cache, cacheEntry, *indexPtr)) {
+            if (!cache_insert(cache, cacheEntry)) {
                 break;
             }
 
+            *cacheEntryPtr = cacheEntry;
+
             return true;
         } while (0);
 
@@ -456,7 +468,7 @@ static bool cache_add(Cache* cache, int key, int* indexPtr)
 }
 
 // 0x41F2E8
-static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index)
+static bool cache_insert(Cache* cache, CacheEntry* cacheEntry)
 {
     // Ensure cache have enough space for new entry.
     if (cache->entriesLength == cache->entriesCapacity - 1) {
@@ -465,58 +477,45 @@ static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index)
         }
     }
 
-    // Move entries below insertion point.
-    memmove(&(cache->entries[index + 1]), &(cache->entries[index]), sizeof(*cache->entries) * (cache->entriesLength - index));
+    // Keep key index at most half full.
+    if ((cache->entriesLength + 1) * 2 > cache->bucketsCapacity) {
+        if (!cache_resize_buckets(cache, cache->bucketsCapacity * 2)) {
+            return false;
+        }
+    }
 
-    cache->entries[index] = cacheEntry;
+    if (!cache_buckets_insert(cache, cacheEntry)) {
+        return false;
+    }
+
+    cache_lru_link(cache, cacheEntry);
+
+    cache->entries[cache->entriesLength] = cacheEntry;
     cache->entriesLength++;
     cache->size += cacheEntry->size;
 
     return true;
 }
 
-// Finds index for given key.
+// Finds cache entry for given key.
 //
-// Returns 2 if entry already exists in cache, or 3 if entry does not exist. In
-// this case indexPtr represents insertion point.
+// Returns `NULL` if entry does not exist.
 //
 // 0x41F354
-static int cache_find(Cache* cache, int key, int* indexPtr)
+static CacheEntry* cache_find(Cache* cache, int key)
 {
-    int length = cache->entriesLength;
-    if (length == 0) {
-        *indexPtr = 0;
-        return 3;
-    }
-
-    int r = length - 1;
-    int l = 0;
-    int mid;
-    int cmp;
+    int mask = cache->bucketsCapacity - 1;
+    int index = cache_bucket_index(cache, key);
 
-    do {
-        mid = (l + r) / 2;
-
-        cmp = key - cache->entries[mid]->key;
-        if (cmp == 0) {
-            *indexPtr = mid;
-            return 2;
-        }
-
-        if (cmp > 0) {
-            l = l + 1;
-        } else {
-            r = r - 1;
+    while (cache->buckets[index] != NULL) {
+        if (cache->buckets[index]->key == key) {
+            return cache->buckets[index];
         }
-    } while (r >= l);
 
-    if (cmp < 0) {
-        *indexPtr = mid;
-    } else {
-        *indexPtr = mid + 1;
+        index = (index + 1) & mask;
     }
 
-    return 3;
+    return NULL;
 }
 
 // 0x41F3C0
@@ -542,7 +541,8 @@ static bool cache_init_item(CacheEntry* cacheEntry)
     cacheEntry->referenceCount = 0;
     cacheEntry->hits = 0;
     cacheEntry->flags = 0;
-    cacheEntry->mru = 0;
+    cacheEntry->lruPrev = NULL;
+    cacheEntry->lruNext = NULL;
     return true;
 }
 
@@ -577,34 +577,6 @@ static bool cache_unlock_all(Cache* cache)
     return true;
 }
 
-// 0x41F4D4
-static bool cache_reset_counter(Cache* cache)
-{
-    if (cache == NULL) {
-        return false;
-    }
-
-    CacheEntry** entries = (CacheEntry**)mem_malloc(sizeof(*entries) * cache->entriesLength);
-    if (entries == NULL) {
-        return false;
-    }
-
-    memcpy(entries, cache->entries, sizeof(*entries) * cache->entriesLength);
-
-    qsort(entries, cache->entriesLength, sizeof(*entries), cache_compare_reset_counter);
-
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = entries[index];
-        cacheEntry->mru = index;
-    }
-
-    cache->hits = cache->entriesLength;
-
-    // FIXME: Obviously leak `entries`.
-
-    return true;
-}
-
 // Prepare cache for storing new entry with the specified size.
 //
 // 0x41F54C
@@ -621,60 +593,51 @@ static bool cache_make_room(Cache* cache, int size)
         return true;
     }
 
-    CacheEntry** entries = (CacheEntry**)mem_malloc(sizeof(*entries) * cache->entriesLength);
-    if (entries != NULL) {
-        memcpy(entries, cache->entries, sizeof(*entries) * cache->entriesLength);
-        qsort(entries, cache->entriesLength, sizeof(*entries), cache_compare_make_room);
+    // The sweeping threshold is 20% of cache size plus size for the new
+    // entry. Once the threshold is reached the marking process stops.
+    int threshold = size + (int)((double)cache->size * 0.2);
 
-        // The sweeping threshold is 20% of cache size plus size for the new
-        // entry. Once the threshold is reached the marking process stops.
-        int threshold = size + (int)((double)cache->size * 0.2);
+    // Walk unreferenced entries starting from the least recently used one.
+    int accum = 0;
+    CacheEntry* entry;
+    for (entry = cache->lruTail; entry != NULL; entry = entry->lruPrev) {
+        if (entry->referenceCount == 0) {
+            if (entry->size >= threshold) {
+                entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
 
-        int accum = 0;
-        int index;
-        for (index = 0; index < cache->entriesLength; index++) {
-            CacheEntry* entry = entries[index];
-            if (entry->referenceCount == 0) {
-                if (entry->size >= threshold) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
+                // We've just found one huge entry, there is no point to
+                // mark individual smaller entries in the code path below,
+                // reset the accumulator to skip it entirely.
+                accum = 0;
+                break;
+            } else {
+                accum += entry->size;
 
-                    // We've just found one huge entry, there is no point to
-                    // mark individual smaller entries in the code path below,
-                    // reset the accumulator to skip it entirely.
-                    accum = 0;
+                if (accum >= threshold) {
                     break;
-                } else {
-                    accum += entry->size;
-
-                    if (accum >= threshold) {
-                        break;
-                    }
                 }
             }
         }
+    }
 
-        if (accum != 0) {
-            // The loop below assumes index to be positioned on the entry, where
-            // accumulator stopped. If we've reached the end, reposition
-            // it to the last entry.
-            if (index == cache->entriesLength) {
-                index -= 1;
+    if (accum != 0) {
+        // Mark all unreferenced entries from the least recently used one up
+        // to the point where accumulator stopped (or all of them if we've
+        // reached the head).
+        for (CacheEntry* curr = cache->lruTail; curr != NULL; curr = curr->lruPrev) {
+            if (curr->referenceCount == 0) {
+                curr->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
             }
 
-            // Loop backwards from the point we've stopped and mark all
-            // unreferenced entries for sweeping.
-            for (; index >= 0; index--) {
-                CacheEntry* entry = entries[index];
-                if (entry->referenceCount == 0) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-                }
+            if (curr == entry) {
+                break;
             }
         }
-
-        mem_free(entries);
     }
 
+    int entriesLength = cache->entriesLength;
     cache_purge(cache);
+    cache->evictions += entriesLength - cache->entriesLength;
 
     if (cache->maxSize - cache->size >= size) {
         return true;
@@ -686,6 +649,7 @@ static bool cache_make_room(Cache* cache, int size)
 // 0x41F69C
 static bool cache_purge(Cache* cache)
 {
+    int length = 0;
     for (int index = 0; index < cache->entriesLength; index++) {
         CacheEntry* cacheEntry = cache->entries[index];
         if ((cacheEntry->flags & CACHE_ENTRY_MARKED_FOR_EVICTION) != 0) {
@@ -694,23 +658,24 @@ static bool cache_purge(Cache* cache)
                 // unmark it.
                 cacheEntry->flags &= ~CACHE_ENTRY_MARKED_FOR_EVICTION;
             } else {
-                int cacheEntrySize = cacheEntry->size;
+                cache->size -= cacheEntry->size;
+
+                cache_buckets_remove(cache, cacheEntry);
+                cache_lru_unlink(cache, cacheEntry);
 
                 // NOTE: Uninline.
                 cache_destroy_item(cache, cacheEntry);
 
-                // Move entries up.
-                memmove(&(cache->entries[index]), &(cache->entries[index + 1]), sizeof(*cache->entries) * ((cache->entriesLength - index) - 1));
-
-                cache->entriesLength--;
-                cache->size -= cacheEntrySize;
-
-                // The entry was removed, compensate index.
-                index--;
+                // The entry was removed, do not keep it in compacted list.
+                continue;
             }
         }
+
+        cache->entries[length++] = cacheEntry;
     }
 
+    cache->entriesLength = length;
+
     return true;
 }
 
@@ -732,48 +697,121 @@ static bool cache_resize_array(Cache* cache, int newCapacity)
     return true;
 }
 
-// 0x41F774
-static int cache_compare_make_room(const void* a1, const void* a2)
+static int cache_bucket_index(Cache* cache, int key)
 {
-    CacheEntry* v1 = *(CacheEntry**)a1;
-    CacheEntry* v2 = *(CacheEntry**)a2;
+    unsigned int hash = (unsigned int)key * 2654435761U;
+    hash ^= hash >> 16;
+    return (int)(hash & (unsigned int)(cache->bucketsCapacity - 1));
+}
 
-    if (v1->referenceCount != 0 && v2->referenceCount == 0) {
-        return 1;
+static bool cache_buckets_insert(Cache* cache, CacheEntry* cacheEntry)
+{
+    int mask = cache->bucketsCapacity - 1;
+    int index = cache_bucket_index(cache, cacheEntry->key);
+
+    while (cache->buckets[index] != NULL) {
+        if (cache->buckets[index]->key == cacheEntry->key) {
+            return false;
+        }
+
+        index = (index + 1) & mask;
     }
 
-    if (v2->referenceCount != 0 && v1->referenceCount == 0) {
-        return -1;
+    cache->buckets[index] = cacheEntry;
+
+    return true;
+}
+
+// Removes entry from key index using backward shift deletion, so there is no
+// need for tombstones.
+static void cache_buckets_remove(Cache* cache, CacheEntry* cacheEntry)
+{
+    int mask = cache->bucketsCapacity - 1;
+    int index = cache_bucket_index(cache, cacheEntry->key);
+
+    while (cache->buckets[index] != cacheEntry) {
+        if (cache->buckets[index] == NULL) {
+            return;
+        }
+
+        index = (index + 1) & mask;
     }
 
-    if (v1->hits < v2->hits) {
-        return -1;
-    } else if (v1->hits > v2->hits) {
-        return 1;
+    int next = index;
+    while (1) {
+        next = (next + 1) & mask;
+        if (cache->buckets[next] == NULL) {
+            break;
+        }
+
+        // Move entry into the hole unless its home slot lies cyclically
+        // within (index, next].
+        int home = cache_bucket_index(cache, cache->buckets[next]->key);
+        if (index <= next ? (index < home && home <= next) : (index < home || home <= next)) {
+            continue;
+        }
+
+        cache->buckets[index] = cache->buckets[next];
+        index = next;
     }
 
-    if (v1->mru < v2->mru) {
-        return -1;
-    } else if (v1->mru > v2->mru) {
-        return 1;
+    cache->buckets[index] = NULL;
+}
+
+static bool cache_resize_buckets(Cache* cache, int newCapacity)
+{
+    CacheEntry** buckets = (CacheEntry**)mem_malloc(sizeof(*buckets) * newCapacity);
+    if (buckets == NULL) {
+        return false;
     }
 
-    return 0;
+    memset(buckets, 0, sizeof(*buckets) * newCapacity);
+
+    if (cache->buckets != NULL) {
+        mem_free(cache->buckets);
+    }
+
+    cache->buckets = buckets;
+    cache->bucketsCapacity = newCapacity;
+
+    for (int index = 0; index < cache->entriesLength; index++) {
+        cache_buckets_insert(cache, cache->entries[index]);
+    }
+
+    return true;
 }
 
-// 0x41F7E8
-static int cache_compare_reset_counter(const void* a1, const void* a2)
+// Inserts entry at the head of recency list.
+static void cache_lru_link(Cache* cache, CacheEntry* cacheEntry)
 {
-    CacheEntry* v1 = *(CacheEntry**)a1;
-    CacheEntry* v2 = *(CacheEntry**)a2;
+    cacheEntry->lruPrev = NULL;
+    cacheEntry->lruNext = cache->lruHead;
 
-    if (v1->mru < v2->mru) {
-        return 1;
-    } else if (v1->mru > v2->mru) {
-        return -1;
+    if (cache->lruHead != NULL) {
+        cache->lruHead->lruPrev = cacheEntry;
     } else {
-        return 0;
+        cache->lruTail = cacheEntry;
     }
+
+    cache->lruHead = cacheEntry;
+}
+
+static void cache_lru_unlink(Cache* cache, CacheEntry* cacheEntry)
+{
+    if (cacheEntry->lruPrev != NULL) {
+        cacheEntry->lruPrev->lruNext = cacheEntry->lruNext;
+    } else {
+        cache->lruHead = cacheEntry->lruNext;
+    }
+
+    if (cacheEntry->lruNext != NULL) {
+        cacheEntry->lruNext->lruPrev = cacheEntry->lruPrev;
+    } else {
+        cache->lruTail = cacheEntry->lruPrev;
+    }
+
+    cacheEntry->lruPrev = NULL;
+    cacheEntry->lruNext = NULL;
 }
 
 } // namespace fallout
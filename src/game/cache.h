@@ -15,6 +15,9 @@ namespace fallout {
 // The number of cache entries added when cache capacity is reached.
 #define CACHE_ENTRIES_GROW_CAPACITY 50
 
+// The initial number of slots in cache key index. Must be a power of two.
+#define CACHE_BUCKETS_INITIAL_CAPACITY 256
+
 typedef enum CacheEntryFlags {
     // Specifies that cache entry has no references as should be evicted during
     // the next sweep operation.
@@ -43,11 +46,12 @@ typedef struct CacheEntry {
 
     unsigned int flags;
 
-    // The most recent hit in terms of cache hit counter. Used to track most
-    // recently used entries in eviction strategy.
-    unsigned int mru;
-
     int heapHandleIndex;
+
+    // Links in cache recency list (see `Cache::lruHead`). Used to pick
+    // eviction victims.
+    struct CacheEntry* lruPrev;
+    struct CacheEntry* lruNext;
 } CacheEntry;
 
 typedef struct Cache {
@@ -63,12 +67,29 @@ typedef struct Cache {
     // The capacity of `entries` array.
     int entriesCapacity;
 
-    // Total number of hits during cache lifetime.
+    // Number of `cache_lock` calls served from existing entries.
     unsigned int hits;
 
-    // List of cache entries.
+    // Number of `cache_lock` calls that had to read entry.
+    unsigned int misses;
+
+    // Number of entries evicted to make room for new ones.
+    unsigned int evictions;
+
+    // List of cache entries (unordered).
     CacheEntry** entries;
 
+    // Open-addressing hash table of cache entries by key (linear probing).
+    CacheEntry** buckets;
+
+    // The capacity of `buckets` array, always a power of two.
+    int bucketsCapacity;
+
+    // Cache entries ordered by recency of use, head is the most recently
+    // locked entry, tail is the least recently locked one.
+    CacheEntry* lruHead;
+    CacheEntry* lruTail;
+
     CacheSizeProc* sizeProc;
     CacheReadProc* readProc;
     CacheFreeProc* freeProc;
@@ -31,6 +31,7 @@
 #include "plib/gnw/debug.h"
 #include "plib/gnw/input.h"
 #include "plib/gnw/memory.h"
+#include "plib/gnw/vcr.h"
 
 namespace fallout {
 
@@ -782,15 +783,18 @@ static Object* ai_search_environ(Object* critter, int itemType)
         return NULL;
     }
 
-    count = obj_create_list(-1, map_elevation, OBJ_TYPE_ITEM, &objects);
-    if (count == 0) {
+    max_distance = stat_level(critter, STAT_PERCEPTION) + 5;
+
+    // Multihex objects are one hex closer as measured by `obj_dist`, so
+    // extend search radius to cover both critter and item being multihex.
+    count = obj_create_list_in_radius(critter->tile, max_distance + 2, map_elevation, OBJ_TYPE_ITEM, &objects);
+    if (count <= 0) {
         return NULL;
     }
 
     // NOTE: Uninline.
     ai_sort_list(objects, count, critter);
 
-    max_distance = stat_level(critter, STAT_PERCEPTION) + 5;
     current_item = inven_right_hand(critter);
 
     found_item = NULL;
@@ -1190,6 +1194,8 @@ void combat_ai_over()
 // 0x425C2C
 Object* combat_ai(Object* critter, Object* target)
 {
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_AI);
+
     AiPacket* ai;
     CritterCombatData* combatData;
 
@@ -7,6 +7,7 @@
 #include "plib/color/color.h"
 #include "plib/db/db.h"
 #include "plib/gnw/text.h"
+#include "plib/gnw/vcr.h"
 
 namespace fallout {
 
@@ -28,9 +29,16 @@ typedef struct InterfaceFontDescriptor {
     short field_A;
     InterfaceFontGlyph glyphs[256];
     unsigned char* data;
+
+    // CE: Glyph rows reduced to runs of non-transparent pixels (see
+    // [FMBuildSpans]), `NULL` if font is drawn pixel by pixel.
+    unsigned char* spans;
+    int spanOffsets[256];
 } InterfaceFontDescriptor;
 
 static int FMLoadFont(int font);
+static void FMBuildSpans(InterfaceFontDescriptor* fontDescriptor, int dataSize);
+static int FMBuildGlyphSpans(const unsigned char* data, int width, int height, unsigned char* spans);
 static void swapUInt32(unsigned int* value);
 static void swapUInt16(unsigned short* value);
 
@@ -61,6 +69,7 @@ int FMInit()
         if (FMLoadFont(font) == -1) {
             gFontCache[font].maxHeight = 0;
             gFontCache[font].data = NULL;
+            gFontCache[font].spans = NULL;
         } else {
             ++gNumFonts;
 
@@ -88,6 +97,10 @@ void FMExit()
         if (gFontCache[font].data != NULL) {
             myfree(gFontCache[font].data, __FILE__, __LINE__); // FONTMGR.C, 124
         }
+
+        if (gFontCache[font].spans != NULL) {
+            myfree(gFontCache[font].spans, __FILE__, __LINE__);
+        }
     }
 }
 
@@ -180,9 +193,84 @@ static int FMLoadFont(int font_index)
 
     db_fclose(stream);
 
+    FMBuildSpans(fontDescriptor, glyphDataSize);
+
     return 0;
 }
 
+// Skips fully transparent pixels of glyphs, so that [FMtext_to_buf] only blends
+// runs of visible ones (transparent pixels do not change destination). Font is
+// left without spans if glyphs are out of data bounds.
+static void FMBuildSpans(InterfaceFontDescriptor* fontDescriptor, int dataSize)
+{
+    fontDescriptor->spans = NULL;
+
+    int size = 0;
+    for (int index = 0; index < 256; index++) {
+        InterfaceFontGlyph* glyph = &(fontDescriptor->glyphs[index]);
+        if (glyph->width < 0 || glyph->width > 255 || glyph->height < 0 || glyph->offset < 0) {
+            return;
+        }
+
+        if (glyph->offset + glyph->width * glyph->height > dataSize) {
+            return;
+        }
+
+        fontDescriptor->spanOffsets[index] = size;
+        size += FMBuildGlyphSpans(fontDescriptor->data + glyph->offset, glyph->width, glyph->height, NULL);
+    }
+
+    fontDescriptor->spans = (unsigned char*)mymalloc(size, __FILE__, __LINE__);
+    if (fontDescriptor->spans == NULL) {
+        return;
+    }
+
+    for (int index = 0; index < 256; index++) {
+        InterfaceFontGlyph* glyph = &(fontDescriptor->glyphs[index]);
+        FMBuildGlyphSpans(fontDescriptor->data + glyph->offset, glyph->width, glyph->height, fontDescriptor->spans + fontDescriptor->spanOffsets[index]);
+    }
+}
+
+// Every glyph row is stored as number of runs followed by offset and length of
+// each run. Returns size of glyph spans, `spans` can be `NULL` to measure it.
+static int FMBuildGlyphSpans(const unsigned char* data, int width, int height, unsigned char* spans)
+{
+    int size = 0;
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = data + width * y;
+        int countOffset = size++;
+        int count = 0;
+
+        int x = 0;
+        while (x < width) {
+            if (row[x] == 0) {
+                x++;
+                continue;
+            }
+
+            int start = x;
+            while (x < width && row[x] != 0) {
+                x++;
+            }
+
+            if (spans != NULL) {
+                spans[size] = start;
+                spans[size + 1] = x - start;
+            }
+
+            size += 2;
+            count++;
+        }
+
+        if (spans != NULL) {
+            spans[countOffset] = count;
+        }
+    }
+
+    return size;
+}
+
 // 0x43AC20
 void FMtext_font(int font)
 {
@@ -307,6 +395,8 @@ int FMtext_curr()
 // 0x43ADB8
 void FMtext_to_buf(unsigned char* buf, const char* string, int length, int pitch, int color)
 {
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_TEXT);
+
     if (!gFMInit) {
         return;
     }
@@ -355,6 +445,27 @@ void FMtext_to_buf(unsigned char* buf, const char* string, int length, int pitch
         // Skip blank pixels (difference between font's line height and glyph height).
         ptr += (gCurrentFont->maxHeight - glyph->height) * pitch;
 
+        if (gCurrentFont->spans != NULL) {
+            unsigned char* spans = gCurrentFont->spans + gCurrentFont->spanOffsets[ch];
+            for (int y = 0; y < glyph->height; y++) {
+                int count = *spans++;
+                for (int index = 0; index < count; index++) {
+                    unsigned char* src = glyphDataPtr + spans[0];
+                    unsigned char* dest = ptr + spans[0];
+                    for (int x = 0; x < spans[1]; x++) {
+                        dest[x] = palette[(src[x] << 8) + dest[x]];
+                    }
+                    spans += 2;
+                }
+
+                glyphDataPtr += glyph->width;
+                ptr += pitch;
+            }
+
+            ptr = end;
+            continue;
+        }
+
         for (int y = 0; y < glyph->height; y++) {
             for (int x = 0; x < glyph->width; x++) {
                 unsigned char byte = *glyphDataPtr++;
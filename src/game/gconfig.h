@@ -29,6 +29,8 @@ namespace fallout {
 #define GAME_CONFIG_HASHING_KEY "hashing"
 #define GAME_CONFIG_SPLASH_KEY "splash"
 #define GAME_CONFIG_FREE_SPACE_KEY "free_space"
+#define GAME_CONFIG_RENDER_THREADS_KEY "render_threads"
+#define GAME_CONFIG_FLOOR_LAYER_KEY "floor_layer"
 #define GAME_CONFIG_TIMES_RUN_KEY "times_run"
 #define GAME_CONFIG_GAME_DIFFICULTY_KEY "game_difficulty"
 #define GAME_CONFIG_RUNNING_BURNING_GUY_KEY "running_burning_guy"
@@ -61,6 +63,7 @@ namespace fallout {
 #define GAME_CONFIG_SNDFX_VOLUME_KEY "sndfx_volume"
 #define GAME_CONFIG_SPEECH_VOLUME_KEY "speech_volume"
 #define GAME_CONFIG_CACHE_SIZE_KEY "cache_size"
+#define GAME_CONFIG_VOICES_KEY "voices"
 #define GAME_CONFIG_MUSIC_PATH1_KEY "music_path1"
 #define GAME_CONFIG_MUSIC_PATH2_KEY "music_path2"
 #define GAME_CONFIG_DEBUG_SFXC_KEY "debug_sfxc"
@@ -69,6 +72,7 @@ namespace fallout {
 #define GAME_CONFIG_SHOW_SCRIPT_MESSAGES_KEY "show_script_messages"
 #define GAME_CONFIG_SHOW_LOAD_INFO_KEY "show_load_info"
 #define GAME_CONFIG_OUTPUT_MAP_DATA_INFO_KEY "output_map_data_info"
+#define GAME_CONFIG_SELFRUN_FAST_FORWARD_KEY "selfrun_fast_forward"
 #define GAME_CONFIG_EXECUTABLE_KEY "executable"
 #define GAME_CONFIG_OVERRIDE_LIBRARIAN_KEY "override_librarian"
 #define GAME_CONFIG_USE_ART_NOT_PROTOS_KEY "use_art_not_protos"
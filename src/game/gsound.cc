@@ -209,6 +209,10 @@ int gsound_init()
 
     soundRegisterAlloc(mem_malloc, mem_realloc, mem_free);
 
+    int voices;
+    config_get_value(&game_config, GAME_CONFIG_SOUND_KEY, GAME_CONFIG_VOICES_KEY, &voices);
+    soundSetMaxVoices(voices);
+
     // initialize direct sound
     if (soundInit(detectDevices, 24, 0x8000, 0x8000, 22050) != 0) {
         if (gsound_debug) {
@@ -57,6 +57,10 @@ void light_set_ambient(int new_ambient_light, bool refresh_screen)
     old_ambient_light = ambient_light;
     ambient_light = normalized;
 
+    if (old_ambient_light != normalized) {
+        tile_floor_layer_invalidate_all();
+    }
+
     if (refresh_screen) {
         if (old_ambient_light != normalized) {
             tile_refresh_display();
@@ -123,6 +127,7 @@ void light_set_tile(int elevation, int tile, int lightIntensity)
     }
 
     tile_intensity[elevation][tile] = lightIntensity;
+    tile_floor_layer_invalidate_tile(elevation, tile);
 }
 
 // 0x46CB78
@@ -137,6 +142,7 @@ void light_add_to_tile(int elevation, int tile, int lightIntensity)
     }
 
     tile_intensity[elevation][tile] += lightIntensity;
+    tile_floor_layer_invalidate_tile(elevation, tile);
 }
 
 // 0x46CBB0
@@ -151,6 +157,31 @@ void light_subtract_from_tile(int elevation, int tile, int lightIntensity)
     }
 
     tile_intensity[elevation][tile] -= lightIntensity;
+    tile_floor_layer_invalidate_tile(elevation, tile);
+}
+
+// Adds (or subtracts) `intensities` to respective `tiles` in one pass. Tiles
+// are expected to be valid.
+void light_adjust_tiles(int elevation, const int* tiles, const int* intensities, int count, bool subtract)
+{
+    if (!elevationIsValid(elevation)) {
+        return;
+    }
+
+    int* intensity = tile_intensity[elevation];
+    if (subtract) {
+        for (int index = 0; index < count; index++) {
+            intensity[tiles[index]] -= intensities[index];
+        }
+    } else {
+        for (int index = 0; index < count; index++) {
+            intensity[tiles[index]] += intensities[index];
+        }
+    }
+
+    for (int index = 0; index < count; index++) {
+        tile_floor_layer_invalidate_tile(elevation, tiles[index]);
+    }
 }
 
 // 0x46CBEC
@@ -164,6 +195,8 @@ void light_reset_tiles()
             tile_intensity[elevation][tile] = 655;
         }
     }
+
+    tile_floor_layer_invalidate_all();
 }
 
 } // namespace fallout
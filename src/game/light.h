@@ -23,6 +23,7 @@ int light_get_tile_true(int elevation, int tile);
 void light_set_tile(int elevation, int tile, int intensity);
 void light_add_to_tile(int elevation, int tile, int intensity);
 void light_subtract_from_tile(int elevation, int tile, int intensity);
+void light_adjust_tiles(int elevation, const int* tiles, const int* intensities, int count, bool subtract);
 void light_reset_tiles();
 
 } // namespace fallout
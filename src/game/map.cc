@@ -1046,7 +1046,19 @@ int map_load_file(DB_FILE* stream)
         map_new_map();
         rc = -1;
     } else {
-        obj_preload_art_cache(map_data.flags);
+        // Map transition moves dude to its destination after the map is
+        // loaded (see [map_check_state]), preload art around it rather than
+        // around entering tile.
+        int preloadTile = tile_center_tile;
+        int preloadElevation = map_elevation;
+        if (map_state.map > 0
+            && map_state.tile != -1 && map_state.tile != 0
+            && elevationIsValid(map_state.elevation)) {
+            preloadTile = map_state.tile;
+            preloadElevation = map_state.elevation;
+        }
+
+        obj_preload_art_cache(map_data.flags, preloadTile, preloadElevation);
     }
 
     partyMemberRecoverLoad();
@@ -1781,6 +1793,8 @@ static void square_reset()
             }
         }
     }
+
+    tile_floor_layer_invalidate_all();
 }
 
 // 0x476084
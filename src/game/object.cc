@@ -31,6 +31,32 @@
 
 namespace fallout {
 
+// Art within this distance (in hexes) from the starting position is loaded
+// immediately by [obj_preload_art_cache], the rest is prefetched in
+// background.
+#define OBJ_PRELOAD_IMMEDIATE_DISTANCE 24
+
+// Distance assigned to art not used on current elevation.
+#define OBJ_PRELOAD_FAR_DISTANCE 0x7FFFFFFF
+
+// Time (in milliseconds) background prefetch is allowed to spend per tick.
+#define OBJ_PRELOAD_TIME_SLICE 4
+
+// Maximum number of tiles lit by single light source: the source tile plus
+// 36 tiles in every direction (see [light_offsets]).
+#define OBJ_LIGHT_FOOTPRINT_SIZE (1 + ROTATION_COUNT * 36)
+
+typedef struct ObjectPreloadEntry {
+    int fid;
+
+    // Distance from the starting position to the closest use of `fid`.
+    int distance;
+
+    // Position in original preload sequence (objects, tiles, walls), used to
+    // break ties between entries at the same distance.
+    int order;
+} ObjectPreloadEntry;
+
 static int obj_read_obj(Object* obj, DB_FILE* stream);
 static int obj_load_func(DB_FILE* stream);
 static void obj_fix_combat_cid_for_dude();
@@ -61,6 +87,16 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect);
 static void obj_render_outline(Object* object, Rect* rect);
 static void obj_render_object(Object* object, Rect* rect, int light);
 static int obj_preload_sort(const void* a1, const void* a2);
+static int obj_preload_distance(int tile, int elevation, int centerTile, int centerElevation);
+static int obj_preload_fid_compare(const void* a1, const void* a2);
+static int obj_preload_entry_compare(const void* a1, const void* a2);
+static void obj_preload_art_cache_bk();
+static void obj_preload_art_cache_reset();
+static void obj_index_init();
+static void obj_index_add(ObjectListNode* node);
+static void obj_index_remove(ObjectListNode* node);
+static int obj_index_create_list(int tile, int radius, int elevation, int objectType, Object*** objectListPtr);
+static int obj_index_tile_compare(const void* a1, const void* a2);
 
 // 0x505B70
 static bool objInitialized = false;
@@ -121,6 +157,16 @@ static int* preload_list = NULL;
 // 0x505BB8
 static int preload_list_index = 0;
 
+// Art waiting to be prefetched by [obj_preload_art_cache_bk], ordered by
+// priority.
+static ObjectPreloadEntry* preload_queue = NULL;
+
+// The number of entries in [preload_queue].
+static int preload_queue_length = 0;
+
+// Index of the next entry in [preload_queue] to prefetch.
+static int preload_queue_index = 0;
+
 // 0x505BBC
 static int translucence = 0;
 
@@ -227,6 +273,14 @@ static Rect buf_rect;
 // 0x6382F0
 static ObjectListNode* objectTable[HEX_GRID_SIZE];
 
+// Secondary index of objects in [objectTable] bucketed by elevation and
+// object type (doubly linked via [ObjectListNode.indexNext]). Allows whole
+// map queries in [obj_create_list] without scanning every tile.
+static ObjectListNode* objectIndex[ELEVATION_COUNT][OBJ_TYPE_COUNT];
+
+// Number of nodes in each [objectIndex] bucket.
+static int objectIndexLength[ELEVATION_COUNT][OBJ_TYPE_COUNT];
+
 // 0x65F3F0
 static Rect updateAreaPixelBounds;
 
@@ -372,6 +426,7 @@ void obj_exit()
         obj_dude->flags &= ~OBJECT_NO_REMOVE;
         obj_egg->flags &= ~OBJECT_NO_REMOVE;
 
+        obj_preload_art_cache_reset();
         obj_remove_all();
         text_object_exit();
 
@@ -1120,6 +1175,8 @@ int obj_disconnect(Object* obj, Rect* rect)
         }
     }
 
+    obj_index_remove(node);
+
     if (node != NULL) {
         mem_free(node);
     }
@@ -1159,6 +1216,8 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
                 }
             }
 
+            obj_index_remove(node);
+
             obj->x += x;
             obj->sx += x;
 
@@ -1183,6 +1242,8 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
                 }
             }
 
+            obj_index_remove(node);
+
             obj->x += x;
             obj->sx += x;
 
@@ -1208,6 +1269,8 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
                 }
             }
 
+            obj_index_remove(node);
+
             obj->x += x;
             obj->sx += x;
 
@@ -1234,6 +1297,8 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
                 }
             }
 
+            obj_index_remove(node);
+
             obj->x += x;
             obj->sx += x;
 
@@ -1282,6 +1347,8 @@ int obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
             }
         }
 
+        obj_index_remove(node);
+
         a1->tile = -1;
         a1->elevation = elevation;
         v22 = 1;
@@ -1310,6 +1377,8 @@ int obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
                 }
             }
 
+            obj_index_remove(node);
+
             a1->elevation = elevation;
             v22 = 1;
         }
@@ -1389,6 +1458,8 @@ int obj_move_to_tile(Object* obj, int tile, int elevation, Rect* rect)
         }
     }
 
+    obj_index_remove(node);
+
     if (obj_connect_to_tile(node, tile, elevation, rect) == -1) {
         return -1;
     }
@@ -1505,6 +1576,8 @@ int obj_change_fid(Object* obj, int fid, Rect* dirtyRect)
         return -1;
     }
 
+    int oldType = FID_TYPE(obj->fid);
+
     if (dirtyRect != NULL) {
         obj_bound(obj, dirtyRect);
 
@@ -1516,6 +1589,15 @@ int obj_change_fid(Object* obj, int fid, Rect* dirtyRect)
         obj->fid = fid;
     }
 
+    // Move object to appropriate bucket of the object index.
+    if (FID_TYPE(fid) != oldType && obj->tile != -1) {
+        ObjectListNode* node;
+        if (obj_node_ptr(obj, &node, NULL) == 0) {
+            obj_index_remove(node);
+            obj_index_add(node);
+        }
+    }
+
     return 0;
 }
 
@@ -1933,6 +2015,8 @@ int obj_toggle_flat(Object* object, Rect* rect)
             }
         }
 
+        obj_index_remove(node);
+
         object->flags ^= OBJECT_FLAT;
 
         obj_insert(node);
@@ -1950,6 +2034,8 @@ int obj_toggle_flat(Object* object, Rect* rect)
             }
         }
 
+        obj_index_remove(node);
+
         object->flags ^= OBJECT_FLAT;
 
         obj_insert(node);
@@ -2409,6 +2495,12 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
         return -1;
     }
 
+    if (tile == -1
+        && elevationIsValid(elevation)
+        && objectType >= 0 && objectType < OBJ_TYPE_COUNT) {
+        return obj_index_create_list(-1, 0, elevation, objectType, objectListPtr);
+    }
+
     int count = 0;
     if (tile == -1) {
         for (int index = 0; index < HEX_GRID_SIZE; index++) {
@@ -2474,6 +2566,29 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
     return count;
 }
 
+// Creates list of objects of given type located within `radius` hexes from
+// `tile`. Objects are listed in the same order as `obj_create_list`.
+int obj_create_list_in_radius(int tile, int radius, int elevation, int objectType, Object*** objectListPtr)
+{
+    if (objectListPtr == NULL) {
+        return -1;
+    }
+
+    if (!hexGridTileIsValid(tile)) {
+        return -1;
+    }
+
+    if (!elevationIsValid(elevation)) {
+        return 0;
+    }
+
+    if (objectType < 0 || objectType >= OBJ_TYPE_COUNT) {
+        return 0;
+    }
+
+    return obj_index_create_list(tile, radius, elevation, objectType, objectListPtr);
+}
+
 // 0x47D628
 void obj_delete_list(Object** objectList)
 {
@@ -2510,32 +2625,17 @@ void translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeigh
 // 0x47D758
 void dark_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int light)
 {
-    unsigned char* sp = src;
-    unsigned char* dp = dest + destPitch * destY + destX;
-
-    int srcStep = srcPitch - srcWidth;
-    int destStep = destPitch - srcWidth;
     // TODO: Name might be confusing.
     int lightModifier = light >> 9;
 
-    for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
-            unsigned char b = *sp;
-            if (b != 0) {
-                if (b < 0xE5) {
-                    b = intensityColorTable[b][lightModifier];
-                }
-
-                *dp = b;
-            }
-
-            sp++;
-            dp++;
-        }
-
-        sp += srcStep;
-        dp += destStep;
+    // Light is the same for the entire blit, so look up intensity column
+    // once and translate pixels through it.
+    unsigned char lut[256];
+    for (int index = 0; index < 256; index++) {
+        lut[index] = index < 0xE5 ? intensityColorTable[index][lightModifier] : index;
     }
+
+    trans_lut_buf_to_buf(src, srcWidth, srcHeight, srcPitch, dest + destPitch * destY + destX, destPitch, lut);
 }
 
 // 0x47D7E4
@@ -2545,20 +2645,32 @@ void dark_translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int src
     int destStep = destPitch - srcWidth;
     int lightModifier = light >> 9;
 
+    unsigned char lut[256];
+    for (int index = 0; index < 256; index++) {
+        lut[index] = intensityColorTable[index][lightModifier];
+    }
+
     dest += destPitch * destY + destX;
 
     for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
+        int x = 0;
+        while (x < srcWidth) {
             unsigned char srcByte = *src;
             if (srcByte != 0) {
                 unsigned char destByte = *dest;
                 unsigned int index = a11[srcByte] << 8;
                 index = a10[index + destByte];
-                *dest = intensityColorTable[index][lightModifier];
-            }
+                *dest = lut[index];
 
-            src++;
-            dest++;
+                src++;
+                dest++;
+                x++;
+            } else {
+                int skip = buf_skip_transparent(src, srcWidth - x);
+                src += skip;
+                dest += skip;
+                x += skip;
+            }
         }
 
         src += srcStep;
@@ -2574,11 +2686,17 @@ void intensity_mask_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight,
     int maskStep = maskPitch - srcWidth;
     light >>= 9;
 
+    unsigned char lut[256];
+    for (int index = 0; index < 256; index++) {
+        lut[index] = intensityColorTable[index][light];
+    }
+
     for (int y = 0; y < srcHeight; y++) {
-        for (int x = 0; x < srcWidth; x++) {
+        int x = 0;
+        while (x < srcWidth) {
             unsigned char b = *src;
             if (b != 0) {
-                b = intensityColorTable[b][light];
+                b = lut[b];
                 unsigned char m = *mask;
                 if (m != 0) {
                     unsigned char d = *dest;
@@ -2587,11 +2705,18 @@ void intensity_mask_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight,
                     b = colorMixAddTable[m][q];
                 }
                 *dest = b;
-            }
 
-            src++;
-            dest++;
-            mask++;
+                src++;
+                dest++;
+                mask++;
+                x++;
+            } else {
+                int skip = buf_skip_transparent(src, srcWidth - x);
+                src += skip;
+                dest += skip;
+                mask += skip;
+                x += skip;
+            }
         }
 
         src += srcStep;
@@ -2882,37 +3007,47 @@ char* object_description(Object* obj)
     return proto_description(obj->pid);
 }
 
+// CE: Art is ranked by distance from `centerTile` at `centerElevation`, which
+// is where the game starts on the loaded map.
+//
 // 0x47E01C
-void obj_preload_art_cache(int flags)
+void obj_preload_art_cache(int flags, int centerTile, int centerElevation)
 {
+    obj_preload_art_cache_reset();
+
     if (preload_list == NULL) {
         return;
     }
 
-    unsigned char arr[4096];
-    memset(arr, 0, sizeof(arr));
-
-    if ((flags & 0x02) == 0) {
-        for (int i = 0; i < SQUARE_GRID_SIZE; i++) {
-            int v3 = square[0]->field_0[i];
-            arr[v3 & 0xFFF] = 1;
-            arr[(v3 >> 16) & 0xFFF] = 1;
-        }
+    // Closest distance to every floor/roof art used on the map, -1 if not
+    // used.
+    int tileDistances[4096];
+    for (int i = 0; i < 4096; i++) {
+        tileDistances[i] = -1;
     }
 
-    if ((flags & 0x04) == 0) {
-        for (int i = 0; i < SQUARE_GRID_SIZE; i++) {
-            int v3 = square[1]->field_0[i];
-            arr[v3 & 0xFFF] = 1;
-            arr[(v3 >> 16) & 0xFFF] = 1;
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        if ((flags & (0x02 << elevation)) != 0) {
+            continue;
         }
-    }
 
-    if ((flags & 0x08) == 0) {
         for (int i = 0; i < SQUARE_GRID_SIZE; i++) {
-            int v3 = square[2]->field_0[i];
-            arr[v3 & 0xFFF] = 1;
-            arr[(v3 >> 16) & 0xFFF] = 1;
+            // Square covers 2x2 hexes, use its top-left hex to measure
+            // distance.
+            int tile = (i / SQUARE_GRID_WIDTH) * 2 * HEX_GRID_WIDTH + (i % SQUARE_GRID_WIDTH) * 2;
+            int distance = obj_preload_distance(tile, elevation, centerTile, centerElevation);
+
+            int v3 = square[elevation]->field_0[i];
+
+            int floorArt = v3 & 0xFFF;
+            if (tileDistances[floorArt] == -1 || distance < tileDistances[floorArt]) {
+                tileDistances[floorArt] = distance;
+            }
+
+            int roofArt = (v3 >> 16) & 0xFFF;
+            if (tileDistances[roofArt] == -1 || distance < tileDistances[roofArt]) {
+                tileDistances[roofArt] = distance;
+            }
         }
     }
 
@@ -2931,40 +3066,130 @@ void obj_preload_art_cache(int flags)
         v11++;
     }
 
-    CacheEntry* cache_handle;
-    if (art_ptr_lock(*preload_list, &cache_handle) != NULL) {
-        art_ptr_unlock(cache_handle);
+    preload_queue = (ObjectPreloadEntry*)mem_malloc(sizeof(*preload_queue) * (preload_list_index + 4096));
+    if (preload_queue == NULL) {
+        mem_free(preload_list);
+        preload_list = NULL;
+        preload_list_index = 0;
+        return;
     }
 
-    for (int i = 1; i < v11; i++) {
-        if (preload_list[i - 1] != preload_list[i]) {
-            if (art_ptr_lock(preload_list[i], &cache_handle) != NULL) {
-                art_ptr_unlock(cache_handle);
-            }
+    // Original load order is non-wall objects, tiles, and then walls.
+    for (int i = 0; i < preload_list_index; i++) {
+        if (i == 0 || preload_list[i - 1] != preload_list[i]) {
+            ObjectPreloadEntry* entry = &(preload_queue[preload_queue_length++]);
+            entry->fid = preload_list[i];
+            entry->distance = OBJ_PRELOAD_FAR_DISTANCE;
+            entry->order = i < v11 ? i : i + 4096;
         }
     }
 
-    for (int i = 0; i < 4096; i++) {
-        if (arr[i] != 0) {
-            int fid = art_id(OBJ_TYPE_TILE, i, 0, 0, 0);
-            if (art_ptr_lock(fid, &cache_handle) != NULL) {
-                art_ptr_unlock(cache_handle);
+    mem_free(preload_list);
+    preload_list = NULL;
+    preload_list_index = 0;
+
+    // [obj_preload_sort] does not distinguish rotations, so reorder by fid to
+    // remove remaining duplicates and to look entries up by fid.
+    qsort(preload_queue, preload_queue_length, sizeof(*preload_queue), obj_preload_fid_compare);
+
+    int objectsLength = 0;
+    for (int i = 0; i < preload_queue_length; i++) {
+        if (objectsLength != 0 && preload_queue[objectsLength - 1].fid == preload_queue[i].fid) {
+            if (preload_queue[i].order < preload_queue[objectsLength - 1].order) {
+                preload_queue[objectsLength - 1].order = preload_queue[i].order;
             }
+        } else {
+            preload_queue[objectsLength++] = preload_queue[i];
         }
     }
+    preload_queue_length = objectsLength;
+
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int objectType = 0; objectType < OBJ_TYPE_COUNT; objectType++) {
+            ObjectListNode* node = objectIndex[elevation][objectType];
+            while (node != NULL) {
+                Object* obj = node->obj;
+                ObjectPreloadEntry* entry = (ObjectPreloadEntry*)bsearch(&(obj->fid), preload_queue, objectsLength, sizeof(*preload_queue), obj_preload_fid_compare);
+                if (entry != NULL) {
+                    int distance = obj_preload_distance(obj->tile, obj->elevation, centerTile, centerElevation);
+                    if (distance < entry->distance) {
+                        entry->distance = distance;
+                    }
+                }
 
-    for (int i = v11; i < preload_list_index; i++) {
-        if (preload_list[i - 1] != preload_list[i]) {
-            if (art_ptr_lock(preload_list[i], &cache_handle) != NULL) {
-                art_ptr_unlock(cache_handle);
+                node = node->indexNext;
             }
         }
     }
 
-    mem_free(preload_list);
-    preload_list = NULL;
+    for (int i = 0; i < 4096; i++) {
+        if (tileDistances[i] != -1) {
+            ObjectPreloadEntry* entry = &(preload_queue[preload_queue_length++]);
+            entry->fid = art_id(OBJ_TYPE_TILE, i, 0, 0, 0);
+            entry->distance = tileDistances[i];
+            entry->order = v11 + i;
+        }
+    }
 
-    preload_list_index = 0;
+    qsort(preload_queue, preload_queue_length, sizeof(*preload_queue), obj_preload_entry_compare);
+
+    // Load art visible around the starting position right away, it's needed
+    // for the first frame anyway.
+    CacheEntry* cache_handle;
+    while (preload_queue_index < preload_queue_length) {
+        ObjectPreloadEntry* entry = &(preload_queue[preload_queue_index]);
+        if (entry->distance > OBJ_PRELOAD_IMMEDIATE_DISTANCE) {
+            break;
+        }
+
+        if (art_ptr_lock(entry->fid, &cache_handle) != NULL) {
+            art_ptr_unlock(cache_handle);
+        }
+
+        preload_queue_index++;
+    }
+
+    if (preload_queue_index < preload_queue_length) {
+        add_bk_process(obj_preload_art_cache_bk);
+    } else {
+        obj_preload_art_cache_reset();
+    }
+}
+
+// Prefetches next portion of [preload_queue] into art cache, limited by
+// [OBJ_PRELOAD_TIME_SLICE] so that it does not stall game loop.
+static void obj_preload_art_cache_bk()
+{
+    unsigned int start = get_time();
+
+    while (preload_queue_index < preload_queue_length) {
+        CacheEntry* cache_handle;
+        if (art_ptr_lock(preload_queue[preload_queue_index].fid, &cache_handle) != NULL) {
+            art_ptr_unlock(cache_handle);
+        }
+
+        preload_queue_index++;
+
+        if (elapsed_time(start) >= OBJ_PRELOAD_TIME_SLICE) {
+            return;
+        }
+    }
+
+    obj_preload_art_cache_reset();
+}
+
+// Cancels pending background prefetch.
+static void obj_preload_art_cache_reset()
+{
+    if (preload_queue != NULL) {
+        remove_bk_process(obj_preload_art_cache_bk);
+
+        mem_free(preload_queue);
+        preload_queue = NULL;
+    }
+
+    preload_queue_length = 0;
+    preload_queue_index = 0;
 }
 
 // 0x47E250
@@ -2976,6 +3201,8 @@ static int obj_object_table_init()
         objectTable[tile] = NULL;
     }
 
+    obj_index_init();
+
     return 0;
 }
 
@@ -3512,6 +3739,10 @@ static int obj_create_object_node(ObjectListNode** nodePtr)
 
     node->obj = NULL;
     node->next = NULL;
+    node->indexPrev = NULL;
+    node->indexNext = NULL;
+    node->indexElevation = -1;
+    node->indexType = -1;
 
     return 0;
 }
@@ -3637,6 +3868,8 @@ static void obj_insert(ObjectListNode* objectListNode)
 
     objectListNode->next = *objectListNodePtr;
     *objectListNodePtr = objectListNode;
+
+    obj_index_add(objectListNode);
 }
 
 // 0x47F13C
@@ -3668,6 +3901,8 @@ static int obj_remove(ObjectListNode* a1, ObjectListNode* a2)
                 objectTable[tile] = objectTable[tile]->next;
             }
         }
+
+        obj_index_remove(a1);
     }
 
     // NOTE: Uninline.
@@ -3679,6 +3914,151 @@ static int obj_remove(ObjectListNode* a1, ObjectListNode* a2)
     return 0;
 }
 
+static void obj_index_init()
+{
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int objectType = 0; objectType < OBJ_TYPE_COUNT; objectType++) {
+            objectIndex[elevation][objectType] = NULL;
+            objectIndexLength[elevation][objectType] = 0;
+        }
+    }
+}
+
+static void obj_index_add(ObjectListNode* node)
+{
+    Object* obj = node->obj;
+    if (obj->tile == -1) {
+        return;
+    }
+
+    int objectType = FID_TYPE(obj->fid);
+    if (!elevationIsValid(obj->elevation) || objectType >= OBJ_TYPE_COUNT) {
+        return;
+    }
+
+    node->indexElevation = obj->elevation;
+    node->indexType = objectType;
+    node->indexPrev = NULL;
+    node->indexNext = objectIndex[obj->elevation][objectType];
+
+    if (node->indexNext != NULL) {
+        node->indexNext->indexPrev = node;
+    }
+
+    objectIndex[obj->elevation][objectType] = node;
+    objectIndexLength[obj->elevation][objectType]++;
+}
+
+static void obj_index_remove(ObjectListNode* node)
+{
+    if (node->indexElevation == -1) {
+        return;
+    }
+
+    if (node->indexPrev != NULL) {
+        node->indexPrev->indexNext = node->indexNext;
+    } else {
+        objectIndex[node->indexElevation][node->indexType] = node->indexNext;
+    }
+
+    if (node->indexNext != NULL) {
+        node->indexNext->indexPrev = node->indexPrev;
+    }
+
+    objectIndexLength[node->indexElevation][node->indexType]--;
+
+    node->indexPrev = NULL;
+    node->indexNext = NULL;
+    node->indexElevation = -1;
+    node->indexType = -1;
+}
+
+// Builds object list from [objectIndex] bucket. When `tile` is -1 all tiles
+// are considered, otherwise only tiles within `radius` from `tile`.
+//
+// Matching tiles are visited in ascending order and objects are taken from
+// [objectTable], so the resulting list is identical to the one produced by
+// scanning the entire map.
+static int obj_index_create_list(int tile, int radius, int elevation, int objectType, Object*** objectListPtr)
+{
+    int length = objectIndexLength[elevation][objectType];
+    if (length == 0) {
+        return 0;
+    }
+
+    int* tiles = (int*)mem_malloc(sizeof(*tiles) * length);
+    if (tiles == NULL) {
+        return -1;
+    }
+
+    int tilesLength = 0;
+    for (ObjectListNode* node = objectIndex[elevation][objectType]; node != NULL; node = node->indexNext) {
+        int objectTile = node->obj->tile;
+        if (tile == -1 || tile_dist(tile, objectTile) <= radius) {
+            tiles[tilesLength++] = objectTile;
+        }
+    }
+
+    qsort(tiles, tilesLength, sizeof(*tiles), obj_index_tile_compare);
+
+    int count = 0;
+    for (int index = 0; index < tilesLength; index++) {
+        if (index > 0 && tiles[index] == tiles[index - 1]) {
+            continue;
+        }
+
+        ObjectListNode* objectListNode = objectTable[tiles[index]];
+        while (objectListNode != NULL) {
+            Object* obj = objectListNode->obj;
+            if ((obj->flags & OBJECT_HIDDEN) == 0
+                && obj->elevation == elevation
+                && FID_TYPE(obj->fid) == objectType) {
+                count++;
+            }
+            objectListNode = objectListNode->next;
+        }
+    }
+
+    if (count == 0) {
+        mem_free(tiles);
+        return 0;
+    }
+
+    Object** objects = *objectListPtr = (Object**)mem_malloc(sizeof(*objects) * count);
+    if (objects == NULL) {
+        mem_free(tiles);
+        return -1;
+    }
+
+    for (int index = 0; index < tilesLength; index++) {
+        if (index > 0 && tiles[index] == tiles[index - 1]) {
+            continue;
+        }
+
+        ObjectListNode* objectListNode = objectTable[tiles[index]];
+        while (objectListNode != NULL) {
+            Object* obj = objectListNode->obj;
+            if ((obj->flags & OBJECT_HIDDEN) == 0
+                && obj->elevation == elevation
+                && FID_TYPE(obj->fid) == objectType) {
+                *objects++ = obj;
+            }
+            objectListNode = objectListNode->next;
+        }
+    }
+
+    mem_free(tiles);
+
+    return count;
+}
+
+static int obj_index_tile_compare(const void* a1, const void* a2)
+{
+    int v1 = *(int*)a1;
+    int v2 = *(int*)a2;
+    return v1 - v2;
+}
+
 // 0x47F20C
 static int obj_connect_to_tile(ObjectListNode* node, int tile, int elevation, Rect* rect)
 {
@@ -3734,8 +4114,15 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         return -1;
     }
 
-    AdjustLightIntensityProc* adjustLightIntensity = a2 ? light_subtract_from_tile : light_add_to_tile;
-    adjustLightIntensity(obj->elevation, obj->tile, obj->lightIntensity);
+    // Footprint is collected first and applied to light map in one pass.
+    // Blocking is decided from objects only, so deferring is safe.
+    int footprintTiles[OBJ_LIGHT_FOOTPRINT_SIZE];
+    int footprintIntensities[OBJ_LIGHT_FOOTPRINT_SIZE];
+    int footprintLength = 0;
+
+    footprintTiles[footprintLength] = obj->tile;
+    footprintIntensities[footprintLength] = obj->lightIntensity;
+    footprintLength++;
 
     Rect objectRect;
     obj_bound(obj, &objectRect);
@@ -4346,8 +4733,10 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
                             objectListNode = objectListNode->next;
                         }
 
-                        if (v12) {
-                            adjustLightIntensity(obj->elevation, tile, v28[index]);
+                        if (v12 && v28[index] != 0) {
+                            footprintTiles[footprintLength] = tile;
+                            footprintIntensities[footprintLength] = v28[index];
+                            footprintLength++;
                         }
                     }
                 }
@@ -4357,20 +4746,30 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         }
     }
 
-    if (rect != NULL) {
-        Rect* lightDistanceRect = &(light_rect[obj->lightDistance]);
-        memcpy(rect, lightDistanceRect, sizeof(*lightDistanceRect));
+    light_adjust_tiles(obj->elevation, footprintTiles, footprintIntensities, footprintLength, a2 != 0);
 
-        int x;
-        int y;
-        tile_coord(obj->tile, &x, &y, obj->elevation);
-        x += 16;
-        y += 8;
-
-        x -= rect->lrx / 2;
-        y -= rect->lry / 2;
+    if (rect != NULL) {
+        // Only tiles which intensity actually changed need redrawing, which
+        // is less than [light_rect] when light is blocked. Every tile is
+        // padded the same way [light_rect] pads the footprint.
+        Rect* tileRect = &(light_rect[0]);
+        for (int index = 0; index < footprintLength; index++) {
+            int x;
+            int y;
+            tile_coord(footprintTiles[index], &x, &y, obj->elevation);
+            x += 16 - tileRect->lrx / 2;
+            y += 8 - tileRect->lry / 2;
+
+            Rect changedRect = *tileRect;
+            rectOffset(&changedRect, x, y);
+
+            if (index == 0) {
+                *rect = changedRect;
+            } else {
+                rect_min_bound(rect, &changedRect, rect);
+            }
+        }
 
-        rectOffset(rect, x, y);
         rect_min_bound(rect, &objectRect, rect);
     }
 
@@ -4926,4 +5325,41 @@ static int obj_preload_sort(const void* a1, const void* a2)
     return cmp;
 }
 
+static int obj_preload_distance(int tile, int elevation, int centerTile, int centerElevation)
+{
+    if (elevation != centerElevation || tile == -1) {
+        return OBJ_PRELOAD_FAR_DISTANCE;
+    }
+
+    return tile_dist(centerTile, tile);
+}
+
+// Compares [ObjectPreloadEntry] by fid. Also used with plain fid as a key
+// since `fid` is the first member.
+static int obj_preload_fid_compare(const void* a1, const void* a2)
+{
+    int v1 = *(int*)a1;
+    int v2 = *(int*)a2;
+
+    if (v1 < v2) {
+        return -1;
+    } else if (v1 > v2) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int obj_preload_entry_compare(const void* a1, const void* a2)
+{
+    ObjectPreloadEntry* v1 = (ObjectPreloadEntry*)a1;
+    ObjectPreloadEntry* v2 = (ObjectPreloadEntry*)a2;
+
+    if (v1->distance != v2->distance) {
+        return v1->distance < v2->distance ? -1 : 1;
+    }
+
+    return v1->order - v2->order;
+}
+
 } // namespace fallout
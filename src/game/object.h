@@ -74,6 +74,7 @@ int obj_scroll_blocking_at(int tile_num, int elev);
 Object* obj_sight_blocking_at(Object* a1, int tile_num, int elev);
 int obj_dist(Object* object1, Object* object2);
 int obj_create_list(int tile, int elevation, int objectType, Object*** objectsPtr);
+int obj_create_list_in_radius(int tile, int radius, int elevation, int objectType, Object*** objectsPtr);
 void obj_delete_list(Object** objects);
 void translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, unsigned char* a9, unsigned char* a10);
 void dark_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int light);
@@ -88,7 +89,7 @@ void obj_set_seen(int tile);
 void obj_process_seen();
 char* object_name(Object* obj);
 char* object_description(Object* obj);
-void obj_preload_art_cache(int flags);
+void obj_preload_art_cache(int flags, int centerTile, int centerElevation);
 int obj_save_obj(DB_FILE* stream, Object* object);
 int obj_load_obj(DB_FILE* stream, Object** objectPtr, int elevation, Object* owner);
 int obj_save_dude(DB_FILE* stream);
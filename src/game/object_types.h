@@ -288,6 +288,13 @@ typedef struct Object {
 typedef struct ObjectListNode {
     Object* obj;
     struct ObjectListNode* next;
+
+    // Links in the per-elevation, per-type object index. Only meaningful when
+    // [indexElevation] is not -1.
+    struct ObjectListNode* indexPrev;
+    struct ObjectListNode* indexNext;
+    int indexElevation;
+    int indexType;
 } ObjectListNode;
 
 #define BUILT_TILE_TILE_MASK 0x3FFFFFF
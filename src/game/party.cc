@@ -106,7 +106,7 @@ int partyMemberAdd(Object* object)
         script->scr_oid = object->id;
 
         object->sid = ((object->pid & 0xFFFFFF) + 18000) | (SCRIPT_TYPE_CRITTER << 24);
-        script->scr_id = object->sid;
+        scr_set_id(script, object->sid);
     }
 
     combatai_switch_team(object, 0);
@@ -323,7 +323,7 @@ int partyMemberRecoverLoad()
             memcpy(script, partyMember->script, sizeof(*script));
 
             partyMember->object->sid = ((partyMember->object->pid & 0xFFFFFF) + 18000) | (SCRIPT_TYPE_CRITTER << 24);
-            script->scr_id = partyMember->object->sid;
+            scr_set_id(script, partyMember->object->sid);
 
             script->program = NULL;
             script->scr_flags &= ~(SCRIPT_FLAG_0x01 | SCRIPT_FLAG_0x04);
@@ -714,7 +714,7 @@ static int partyMemberItemRecover(PartyMember* partyMember)
     memcpy(script, partyMember->script, sizeof(*script));
 
     partyMember->object->sid = partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24);
-    script->scr_id = partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24);
+    scr_set_id(script, partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24));
 
     script->program = NULL;
     script->scr_flags &= ~(SCRIPT_FLAG_0x01 | SCRIPT_FLAG_0x04 | SCRIPT_FLAG_0x08 | SCRIPT_FLAG_0x10);
@@ -25,6 +25,18 @@
 
 namespace fallout {
 
+// Number of object types with protos on disk (items through misc).
+#define PROTO_INDEX_TYPE_COUNT 6
+
+// Direct-indexed cache of loaded protos of one type. PIDs are dense within
+// type, so [protos] is indexed by PID id. [missing] remembers ids which
+// failed to load to avoid hitting disk again.
+typedef struct ProtoIndex {
+    Proto** protos;
+    unsigned char* missing;
+    int capacity;
+} ProtoIndex;
+
 static char* proto_get_msg_info(int pid, int message);
 static int proto_read_CombatData(CritterCombatData* data, DB_FILE* stream);
 static int proto_write_CombatData(CritterCombatData* data, DB_FILE* stream);
@@ -35,6 +47,9 @@ static int proto_write_item_data(ItemProtoData* item_data, int type, DB_FILE* st
 static int proto_write_scenery_data(SceneryProtoData* scenery_data, int type, DB_FILE* stream);
 static int proto_write_protoSubNode(Proto* buf, DB_FILE* stream);
 static int proto_new_id(int a1);
+static bool proto_index_reserve(int type, int id);
+static void proto_index_clear();
+static int proto_read_pid(int pid, Proto** protoPtr, bool* missingPtr);
 
 // 0x50734C
 char cd_path_base[COMPAT_MAX_PATH];
@@ -72,6 +87,8 @@ static const size_t proto_sizes[11] = {
 // 0x50752C
 static int protos_been_initialized = 0;
 
+static ProtoIndex proto_index[PROTO_INDEX_TYPE_COUNT];
+
 // 0x507530
 static CritterProto pc_proto = {
     0x1000000,
@@ -1625,11 +1642,23 @@ int proto_save_pid(int pid)
 // 0x490034
 int proto_load_pid(int pid, Proto** protoPtr)
 {
+    bool missing;
+    return proto_read_pid(pid, protoPtr, &missing);
+}
+
+// Loads proto as [proto_load_pid]. On failure `missingPtr` tells whether proto
+// does not exist or cannot be parsed (as opposed to failing to allocate it),
+// so that later loads are bound to fail as well.
+static int proto_read_pid(int pid, Proto** protoPtr, bool* missingPtr)
+{
+    *missingPtr = false;
+
     char path[COMPAT_MAX_PATH];
     proto_make_path(path, pid);
     strcat(path, "\\");
 
     if (proto_list_str(pid, path + strlen(path)) == -1) {
+        *missingPtr = true;
         return -1;
     }
 
@@ -1637,6 +1666,7 @@ int proto_load_pid(int pid, Proto** protoPtr)
     if (stream == NULL) {
         debug_printf("\nError: Can't fopen proto!\n");
         *protoPtr = NULL;
+        *missingPtr = true;
         return -1;
     }
 
@@ -1647,6 +1677,7 @@ int proto_load_pid(int pid, Proto** protoPtr)
 
     if (proto_read_protoSubNode(*protoPtr, stream) != 0) {
         db_fclose(stream);
+        *missingPtr = true;
         return -1;
     }
 
@@ -1729,6 +1760,65 @@ void proto_remove_all()
         protoList->tail = NULL;
         protoList->length = 0;
     }
+
+    proto_index_clear();
+}
+
+// Makes sure [proto_index] of given type covers [id]. Only ids listed in
+// .lst (including ones created in this session) are indexed, everything else
+// goes through the slow path.
+static bool proto_index_reserve(int type, int id)
+{
+    if (type < 0 || type >= PROTO_INDEX_TYPE_COUNT) {
+        return false;
+    }
+
+    if (id >= protolists[type].max_entries_num) {
+        return false;
+    }
+
+    ProtoIndex* protoIndex = &(proto_index[type]);
+    if (id < protoIndex->capacity) {
+        return true;
+    }
+
+    int capacity = protolists[type].max_entries_num;
+
+    Proto** protos = (Proto**)mem_realloc(protoIndex->protos, sizeof(*protos) * capacity);
+    if (protos == NULL) {
+        return false;
+    }
+    protoIndex->protos = protos;
+
+    unsigned char* missing = (unsigned char*)mem_realloc(protoIndex->missing, sizeof(*missing) * capacity);
+    if (missing == NULL) {
+        return false;
+    }
+    protoIndex->missing = missing;
+
+    memset(protos + protoIndex->capacity, 0, sizeof(*protos) * (capacity - protoIndex->capacity));
+    memset(missing + protoIndex->capacity, 0, sizeof(*missing) * (capacity - protoIndex->capacity));
+    protoIndex->capacity = capacity;
+
+    return true;
+}
+
+static void proto_index_clear()
+{
+    for (int type = 0; type < PROTO_INDEX_TYPE_COUNT; type++) {
+        ProtoIndex* protoIndex = &(proto_index[type]);
+        if (protoIndex->protos != NULL) {
+            mem_free(protoIndex->protos);
+            protoIndex->protos = NULL;
+        }
+
+        if (protoIndex->missing != NULL) {
+            mem_free(protoIndex->missing);
+            protoIndex->missing = NULL;
+        }
+
+        protoIndex->capacity = 0;
+    }
 }
 
 // 0x4904AC
@@ -1745,7 +1835,34 @@ int proto_ptr(int pid, Proto** protoPtr)
         return 0;
     }
 
-    ProtoList* protoList = &(protolists[PID_TYPE(pid)]);
+    int type = PID_TYPE(pid);
+    int id = pid & 0xFFFFFF;
+    if (proto_index_reserve(type, id)) {
+        ProtoIndex* protoIndex = &(proto_index[type]);
+        if (protoIndex->protos[id] != NULL) {
+            *protoPtr = protoIndex->protos[id];
+            return 0;
+        }
+
+        if (protoIndex->missing[id]) {
+            return -1;
+        }
+
+        bool missing;
+        if (proto_read_pid(pid, protoPtr, &missing) == -1) {
+            // Allocation failures are not remembered, they might not happen
+            // next time.
+            if (missing) {
+                protoIndex->missing[id] = 1;
+            }
+            return -1;
+        }
+
+        protoIndex->protos[id] = *protoPtr;
+        return 0;
+    }
+
+    ProtoList* protoList = &(protolists[type]);
     ProtoListExtent* protoListExtent = protoList->head;
     while (protoListExtent != NULL) {
         for (int index = 0; index < protoListExtent->length; index++) {
@@ -1,5 +1,8 @@
 #include "game/queue.h"
 
+#include <stdint.h>
+#include <stdlib.h>
+
 #include "game/actions.h"
 #include "game/critter.h"
 #include "game/display.h"
@@ -17,20 +20,65 @@
 
 namespace fallout {
 
+// Number of nodes allocated at once by [queue_alloc_node].
+#define QUEUE_NODE_POOL_BLOCK_SIZE 64
+
+// The number of buckets in [queue_owner_buckets]. Must be a power of two.
+#define QUEUE_OWNER_BUCKETS 512
+
 typedef struct QueueListNode {
     // TODO: Make unsigned.
     int time;
     int type;
     Object* owner;
     void* data;
+
+    // Order in which event was added, breaks ties between events scheduled
+    // for the same time.
+    unsigned int seq;
+
+    // Position in [queue_heap], -1 if node is not scheduled.
+    int heapIndex;
+
+    // Links in owner bucket (see [queue_owner_buckets]).
+    struct QueueListNode* ownerPrev;
+    struct QueueListNode* ownerNext;
+
+    // Links in list of events of the same type (see [queue_type_lists]).
+    struct QueueListNode* typePrev;
+    struct QueueListNode* typeNext;
+
+    // Next node in free list when node is not used.
     struct QueueListNode* next;
 } QueueListNode;
 
+typedef struct QueueNodePoolBlock {
+    struct QueueNodePoolBlock* next;
+    QueueListNode nodes[QUEUE_NODE_POOL_BLOCK_SIZE];
+} QueueNodePoolBlock;
+
+// Snapshot of scheduled event used by [queue_clear_type].
+typedef struct QueueClearEntry {
+    int time;
+    unsigned int seq;
+    QueueListNode* node;
+} QueueClearEntry;
+
 static int queue_destroy(Object* obj, void* data);
 static int queue_explode(Object* obj, void* data);
 static int queue_explode_exit(Object* obj, void* data);
 static int queue_do_explosion(Object* obj, bool a2);
 static int queue_premature(Object* obj, void* data);
+static QueueListNode* queue_alloc_node();
+static void queue_free_node(QueueListNode* node);
+static bool queue_node_less(QueueListNode* a, QueueListNode* b);
+static int queue_node_compare(const void* a1, const void* a2);
+static int queue_clear_entry_compare(const void* a1, const void* a2);
+static void queue_heap_sift_up(int index);
+static void queue_heap_sift_down(int index);
+static bool queue_link(QueueListNode* node);
+static void queue_unlink(QueueListNode* node);
+static int queue_owner_bucket(Object* owner);
 
 // 0x5076FC
 EventTypeDescription q_func[EVENT_TYPE_COUNT] = {
@@ -49,13 +97,41 @@ EventTypeDescription q_func[EVENT_TYPE_COUNT] = {
     { scr_map_q_process, NULL, NULL, NULL, true, NULL },
 };
 
-// 0x662F4C
-static QueueListNode* queue;
+// Scheduled events as binary min-heap ordered by time and then by `seq`.
+static QueueListNode** queue_heap = NULL;
+static int queue_heap_length = 0;
+static int queue_heap_capacity = 0;
+
+// Scheduled events bucketed by owner, doubly linked via
+// [QueueListNode.ownerNext].
+static QueueListNode* queue_owner_buckets[QUEUE_OWNER_BUCKETS];
+
+// Scheduled events of every type, doubly linked via
+// [QueueListNode.typeNext].
+static QueueListNode* queue_type_lists[EVENT_TYPE_COUNT];
+
+// Value of [QueueListNode.seq] for the next added event.
+static unsigned int queue_next_seq = 0;
+
+// Blocks of nodes allocated by [queue_alloc_node].
+static QueueNodePoolBlock* queue_pool_blocks = NULL;
+
+// Unused nodes from [queue_pool_blocks].
+static QueueListNode* queue_free_nodes = NULL;
 
 // 0x490670
 void queue_init()
 {
-    queue = NULL;
+    queue_heap_length = 0;
+    queue_next_seq = 0;
+
+    for (int index = 0; index < QUEUE_OWNER_BUCKETS; index++) {
+        queue_owner_buckets[index] = NULL;
+    }
+
+    for (int index = 0; index < EVENT_TYPE_COUNT; index++) {
+        queue_type_lists[index] = NULL;
+    }
 }
 
 // 0x490680
@@ -69,6 +145,22 @@ int queue_reset()
 int queue_exit()
 {
     queue_clear();
+
+    while (queue_pool_blocks != NULL) {
+        QueueNodePoolBlock* next = queue_pool_blocks->next;
+        mem_free(queue_pool_blocks);
+        queue_pool_blocks = next;
+    }
+
+    queue_free_nodes = NULL;
+
+    if (queue_heap != NULL) {
+        mem_free(queue_heap);
+        queue_heap = NULL;
+    }
+
+    queue_heap_capacity = 0;
+
     return 0;
 }
 
@@ -80,33 +172,31 @@ int queue_load(DB_FILE* stream)
         return -1;
     }
 
-    queue = NULL;
-
-    QueueListNode** nextPtr = &queue;
+    queue_clear();
 
     int rc = 0;
     for (int index = 0; index < count; index += 1) {
-        QueueListNode* queueListNode = (QueueListNode*)mem_malloc(sizeof(*queueListNode));
+        QueueListNode* queueListNode = queue_alloc_node();
         if (queueListNode == NULL) {
             rc = -1;
             break;
         }
 
         if (db_freadInt(stream, &(queueListNode->time)) == -1) {
-            mem_free(queueListNode);
+            queue_free_node(queueListNode);
             rc = -1;
             break;
         }
 
         if (db_freadInt(stream, &(queueListNode->type)) == -1) {
-            mem_free(queueListNode);
+            queue_free_node(queueListNode);
             rc = -1;
             break;
         }
 
         int objectId;
         if (db_freadInt(stream, &objectId) == -1) {
-            mem_free(queueListNode);
+            queue_free_node(queueListNode);
             rc = -1;
             break;
         }
@@ -130,7 +220,7 @@ int queue_load(DB_FILE* stream)
         EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
         if (eventTypeDescription->readProc != NULL) {
             if (eventTypeDescription->readProc(stream, &(queueListNode->data)) == -1) {
-                mem_free(queueListNode);
+                queue_free_node(queueListNode);
                 rc = -1;
                 break;
             }
@@ -138,49 +228,45 @@ int queue_load(DB_FILE* stream)
             queueListNode->data = NULL;
         }
 
-        queueListNode->next = NULL;
+        // Events are saved in order they are processed, so assigning
+        // sequence in file order preserves it.
+        queueListNode->seq = queue_next_seq++;
 
-        *nextPtr = queueListNode;
-        nextPtr = &(queueListNode->next);
-    }
-
-    if (rc == -1) {
-        while (queue != NULL) {
-            QueueListNode* next = queue->next;
-
-            EventTypeDescription* eventTypeDescription = &(q_func[queue->type]);
+        if (!queue_link(queueListNode)) {
             if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(queue->data);
+                eventTypeDescription->freeProc(queueListNode->data);
             }
 
-            mem_free(queue);
-
-            queue = next;
+            queue_free_node(queueListNode);
+            rc = -1;
+            break;
         }
     }
 
+    if (rc == -1) {
+        queue_clear();
+    }
+
     return rc;
 }
 
 // 0x4907F4
 int queue_save(DB_FILE* stream)
 {
-    QueueListNode* queueListNode;
+    // Sorted array is a valid heap, so sort heap in place to write events in
+    // order they are processed.
+    qsort(queue_heap, queue_heap_length, sizeof(*queue_heap), queue_node_compare);
 
-    int count = 0;
-
-    queueListNode = queue;
-    while (queueListNode != NULL) {
-        count += 1;
-        queueListNode = queueListNode->next;
+    for (int index = 0; index < queue_heap_length; index++) {
+        queue_heap[index]->heapIndex = index;
     }
 
-    if (db_fwriteInt(stream, count) == -1) {
+    if (db_fwriteInt(stream, queue_heap_length) == -1) {
         return -1;
     }
 
-    queueListNode = queue;
-    while (queueListNode != NULL) {
+    for (int index = 0; index < queue_heap_length; index++) {
+        QueueListNode* queueListNode = queue_heap[index];
         Object* object = queueListNode->owner;
         int objectId = object != NULL ? object->id : -2;
 
@@ -202,8 +288,6 @@ int queue_save(DB_FILE* stream)
                 return -1;
             }
         }
-
-        queueListNode = queueListNode->next;
     }
 
     return 0;
@@ -212,7 +296,7 @@ int queue_save(DB_FILE* stream)
 // 0x4908A0
 int queue_add(int delay, Object* obj, void* data, int eventType)
 {
-    QueueListNode* newQueueListNode = (QueueListNode*)mem_malloc(sizeof(QueueListNode));
+    QueueListNode* newQueueListNode = queue_alloc_node();
     if (newQueueListNode == NULL) {
         return -1;
     }
@@ -223,54 +307,39 @@ int queue_add(int delay, Object* obj, void* data, int eventType)
     newQueueListNode->type = eventType;
     newQueueListNode->owner = obj;
     newQueueListNode->data = data;
+    newQueueListNode->seq = queue_next_seq++;
 
-    if (obj != NULL) {
-        obj->flags |= OBJECT_USED;
+    if (!queue_link(newQueueListNode)) {
+        queue_free_node(newQueueListNode);
+        return -1;
     }
 
-    QueueListNode** v3 = &queue;
-
-    if (queue != NULL) {
-        QueueListNode* v4;
-
-        do {
-            v4 = *v3;
-            if (v2 < v4->time) {
-                break;
-            }
-            v3 = &(v4->next);
-        } while (v4->next != NULL);
+    if (obj != NULL) {
+        obj->flags |= OBJECT_USED;
     }
 
-    newQueueListNode->next = *v3;
-    *v3 = newQueueListNode;
-
     return 0;
 }
 
 // 0x490908
 int queue_remove(Object* owner)
 {
-    QueueListNode* queueListNode = queue;
-    QueueListNode** queueListNodePtr = &queue;
+    QueueListNode* queueListNode = queue_owner_buckets[queue_owner_bucket(owner)];
+    while (queueListNode != NULL) {
+        QueueListNode* next = queueListNode->ownerNext;
 
-    while (queueListNode) {
         if (queueListNode->owner == owner) {
-            QueueListNode* temp = queueListNode;
-
-            queueListNode = queueListNode->next;
-            *queueListNodePtr = queueListNode;
+            queue_unlink(queueListNode);
 
-            EventTypeDescription* eventTypeDescription = &(q_func[temp->type]);
+            EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
             if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(temp->data);
+                eventTypeDescription->freeProc(queueListNode->data);
             }
 
-            mem_free(temp);
-        } else {
-            queueListNodePtr = &(queueListNode->next);
-            queueListNode = queueListNode->next;
+            queue_free_node(queueListNode);
         }
+
+        queueListNode = next;
     }
 
     return 0;
@@ -279,26 +348,22 @@ int queue_remove(Object* owner)
 // 0x490960
 int queue_remove_this(Object* owner, int eventType)
 {
-    QueueListNode* queueListNode = queue;
-    QueueListNode** queueListNodePtr = &queue;
+    QueueListNode* queueListNode = queue_owner_buckets[queue_owner_bucket(owner)];
+    while (queueListNode != NULL) {
+        QueueListNode* next = queueListNode->ownerNext;
 
-    while (queueListNode) {
         if (queueListNode->owner == owner && queueListNode->type == eventType) {
-            QueueListNode* temp = queueListNode;
-
-            queueListNode = queueListNode->next;
-            *queueListNodePtr = queueListNode;
+            queue_unlink(queueListNode);
 
-            EventTypeDescription* eventTypeDescription = &(q_func[temp->type]);
+            EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
             if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(temp->data);
+                eventTypeDescription->freeProc(queueListNode->data);
             }
 
-            mem_free(temp);
-        } else {
-            queueListNodePtr = &(queueListNode->next);
-            queueListNode = queueListNode->next;
+            queue_free_node(queueListNode);
         }
+
+        queueListNode = next;
     }
 
     return 0;
@@ -309,13 +374,13 @@ int queue_remove_this(Object* owner, int eventType)
 // 0x4909BC
 bool queue_find(Object* owner, int eventType)
 {
-    QueueListNode* queueListEvent = queue;
+    QueueListNode* queueListEvent = queue_owner_buckets[queue_owner_bucket(owner)];
     while (queueListEvent != NULL) {
         if (owner == queueListEvent->owner && eventType == queueListEvent->type) {
             return true;
         }
 
-        queueListEvent = queueListEvent->next;
+        queueListEvent = queueListEvent->ownerNext;
     }
 
     return false;
@@ -327,13 +392,13 @@ int queue_process()
     int time = game_time();
     int v1 = 0;
 
-    while (queue != NULL) {
-        QueueListNode* queueListNode = queue;
+    while (queue_heap_length != 0) {
+        QueueListNode* queueListNode = queue_heap[0];
         if (time < queueListNode->time || v1 != 0) {
             break;
         }
 
-        queue = queueListNode->next;
+        queue_unlink(queueListNode);
 
         EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
         v1 = eventTypeDescription->handlerProc(queueListNode->owner, queueListNode->data);
@@ -342,7 +407,7 @@ int queue_process()
             eventTypeDescription->freeProc(queueListNode->data);
         }
 
-        mem_free(queueListNode);
+        queue_free_node(queueListNode);
     }
 
     return v1;
@@ -351,52 +416,93 @@ int queue_process()
 // 0x490A5C
 void queue_clear()
 {
-    QueueListNode* queueListNode = queue;
-    while (queueListNode != NULL) {
-        QueueListNode* next = queueListNode->next;
+    for (int index = 0; index < queue_heap_length; index++) {
+        QueueListNode* queueListNode = queue_heap[index];
 
         EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
         if (eventTypeDescription->freeProc != NULL) {
             eventTypeDescription->freeProc(queueListNode->data);
         }
 
-        mem_free(queueListNode);
+        queueListNode->heapIndex = -1;
+        queue_free_node(queueListNode);
+    }
 
-        queueListNode = next;
+    queue_heap_length = 0;
+
+    for (int index = 0; index < QUEUE_OWNER_BUCKETS; index++) {
+        queue_owner_buckets[index] = NULL;
     }
 
-    queue = NULL;
+    for (int index = 0; index < EVENT_TYPE_COUNT; index++) {
+        queue_type_lists[index] = NULL;
+    }
 }
 
 // 0x490AA4
 void queue_clear_type(int eventType, QueueEventHandler* fn)
 {
-    QueueListNode** ptr = &queue;
-    QueueListNode* curr = *ptr;
+    int count = 0;
+    QueueListNode* queueListNode = queue_type_lists[eventType];
+    while (queueListNode != NULL) {
+        count++;
+        queueListNode = queueListNode->typeNext;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    // Callbacks are free to add or remove events, so work on a snapshot
+    // sorted in processing order. Nodes are pooled, so `seq` tells if node
+    // still holds the same event.
+    QueueClearEntry* snapshot = (QueueClearEntry*)mem_malloc(sizeof(*snapshot) * count);
+    if (snapshot == NULL) {
+        return;
+    }
+
+    count = 0;
+    queueListNode = queue_type_lists[eventType];
+    while (queueListNode != NULL) {
+        snapshot[count].time = queueListNode->time;
+        snapshot[count].seq = queueListNode->seq;
+        snapshot[count].node = queueListNode;
+        count++;
+        queueListNode = queueListNode->typeNext;
+    }
+
+    qsort(snapshot, count, sizeof(*snapshot), queue_clear_entry_compare);
 
-    while (curr != NULL) {
-        if (eventType == curr->type) {
-            QueueListNode* tmp = curr;
+    for (int index = 0; index < count; index++) {
+        QueueListNode* tmp = snapshot[index].node;
+        if (tmp->heapIndex == -1 || tmp->seq != snapshot[index].seq) {
+            continue;
+        }
 
-            *ptr = curr->next;
-            curr = *ptr;
+        queue_unlink(tmp);
 
-            if (fn != NULL && fn(tmp->owner, tmp->data) != 1) {
-                *ptr = tmp;
-                ptr = &(tmp->next);
-            } else {
+        if (fn != NULL && fn(tmp->owner, tmp->data) != 1) {
+            // Put event back, it keeps its place since time and `seq` are
+            // unchanged.
+            if (!queue_link(tmp)) {
                 EventTypeDescription* eventTypeDescription = &(q_func[tmp->type]);
                 if (eventTypeDescription->freeProc != NULL) {
                     eventTypeDescription->freeProc(tmp->data);
                 }
 
-                mem_free(tmp);
+                queue_free_node(tmp);
             }
         } else {
-            ptr = &(curr->next);
-            curr = *ptr;
+            EventTypeDescription* eventTypeDescription = &(q_func[tmp->type]);
+            if (eventTypeDescription->freeProc != NULL) {
+                eventTypeDescription->freeProc(tmp->data);
+            }
+
+            queue_free_node(tmp);
         }
     }
+
+    mem_free(snapshot);
 }
 
 // TODO: Make unsigned.
@@ -404,11 +510,215 @@ void queue_clear_type(int eventType, QueueEventHandler* fn)
 // 0x490B1C
 int queue_next_time()
 {
-    if (queue == NULL) {
+    if (queue_heap_length == 0) {
         return 0;
     }
 
-    return queue->time;
+    return queue_heap[0]->time;
+}
+
+static QueueListNode* queue_alloc_node()
+{
+    if (queue_free_nodes == NULL) {
+        QueueNodePoolBlock* block = (QueueNodePoolBlock*)mem_malloc(sizeof(*block));
+        if (block == NULL) {
+            return NULL;
+        }
+
+        block->next = queue_pool_blocks;
+        queue_pool_blocks = block;
+
+        for (int index = 0; index < QUEUE_NODE_POOL_BLOCK_SIZE; index++) {
+            block->nodes[index].heapIndex = -1;
+            block->nodes[index].next = queue_free_nodes;
+            queue_free_nodes = &(block->nodes[index]);
+        }
+    }
+
+    QueueListNode* node = queue_free_nodes;
+    queue_free_nodes = node->next;
+
+    node->heapIndex = -1;
+    node->next = NULL;
+
+    return node;
+}
+
+static void queue_free_node(QueueListNode* node)
+{
+    node->heapIndex = -1;
+    node->next = queue_free_nodes;
+    queue_free_nodes = node;
+}
+
+static bool queue_node_less(QueueListNode* a, QueueListNode* b)
+{
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+
+    // Wrap-around safe.
+    return (int)(a->seq - b->seq) < 0;
+}
+
+static int queue_node_compare(const void* a1, const void* a2)
+{
+    QueueListNode* v1 = *(QueueListNode**)a1;
+    QueueListNode* v2 = *(QueueListNode**)a2;
+
+    if (queue_node_less(v1, v2)) {
+        return -1;
+    }
+
+    if (queue_node_less(v2, v1)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int queue_clear_entry_compare(const void* a1, const void* a2)
+{
+    QueueClearEntry* v1 = (QueueClearEntry*)a1;
+    QueueClearEntry* v2 = (QueueClearEntry*)a2;
+
+    if (v1->time != v2->time) {
+        return v1->time < v2->time ? -1 : 1;
+    }
+
+    int diff = (int)(v1->seq - v2->seq);
+    if (diff != 0) {
+        return diff < 0 ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static void queue_heap_sift_up(int index)
+{
+    QueueListNode* node = queue_heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!queue_node_less(node, queue_heap[parent])) {
+            break;
+        }
+
+        queue_heap[index] = queue_heap[parent];
+        queue_heap[index]->heapIndex = index;
+        index = parent;
+    }
+
+    queue_heap[index] = node;
+    node->heapIndex = index;
+}
+
+static void queue_heap_sift_down(int index)
+{
+    QueueListNode* node = queue_heap[index];
+    for (;;) {
+        int child = index * 2 + 1;
+        if (child >= queue_heap_length) {
+            break;
+        }
+
+        if (child + 1 < queue_heap_length && queue_node_less(queue_heap[child + 1], queue_heap[child])) {
+            child++;
+        }
+
+        if (!queue_node_less(queue_heap[child], node)) {
+            break;
+        }
+
+        queue_heap[index] = queue_heap[child];
+        queue_heap[index]->heapIndex = index;
+        index = child;
+    }
+
+    queue_heap[index] = node;
+    node->heapIndex = index;
+}
+
+// Schedules node in heap and adds it to owner and type indexes.
+static bool queue_link(QueueListNode* node)
+{
+    if (queue_heap_length == queue_heap_capacity) {
+        int capacity = queue_heap_capacity != 0 ? queue_heap_capacity * 2 : 64;
+        QueueListNode** heap = (QueueListNode**)mem_realloc(queue_heap, sizeof(*heap) * capacity);
+        if (heap == NULL) {
+            return false;
+        }
+
+        queue_heap = heap;
+        queue_heap_capacity = capacity;
+    }
+
+    queue_heap[queue_heap_length] = node;
+    queue_heap_length++;
+    queue_heap_sift_up(queue_heap_length - 1);
+
+    int bucket = queue_owner_bucket(node->owner);
+    node->ownerPrev = NULL;
+    node->ownerNext = queue_owner_buckets[bucket];
+    if (node->ownerNext != NULL) {
+        node->ownerNext->ownerPrev = node;
+    }
+    queue_owner_buckets[bucket] = node;
+
+    node->typePrev = NULL;
+    node->typeNext = queue_type_lists[node->type];
+    if (node->typeNext != NULL) {
+        node->typeNext->typePrev = node;
+    }
+    queue_type_lists[node->type] = node;
+
+    return true;
+}
+
+// Removes node from heap and indexes, node is not freed.
+static void queue_unlink(QueueListNode* node)
+{
+    int index = node->heapIndex;
+
+    queue_heap_length--;
+    if (index != queue_heap_length) {
+        QueueListNode* last = queue_heap[queue_heap_length];
+        queue_heap[index] = last;
+        last->heapIndex = index;
+
+        if (index > 0 && queue_node_less(last, queue_heap[(index - 1) / 2])) {
+            queue_heap_sift_up(index);
+        } else {
+            queue_heap_sift_down(index);
+        }
+    }
+
+    node->heapIndex = -1;
+
+    if (node->ownerPrev != NULL) {
+        node->ownerPrev->ownerNext = node->ownerNext;
+    } else {
+        queue_owner_buckets[queue_owner_bucket(node->owner)] = node->ownerNext;
+    }
+
+    if (node->ownerNext != NULL) {
+        node->ownerNext->ownerPrev = node->ownerPrev;
+    }
+
+    if (node->typePrev != NULL) {
+        node->typePrev->typeNext = node->typeNext;
+    } else {
+        queue_type_lists[node->type] = node->typeNext;
+    }
+
+    if (node->typeNext != NULL) {
+        node->typeNext->typePrev = node->typePrev;
+    }
+}
+
+static int queue_owner_bucket(Object* owner)
+{
+    uintptr_t value = (uintptr_t)owner;
+    return (int)(((value >> 4) ^ (value >> 13)) & (QUEUE_OWNER_BUCKETS - 1));
 }
 
 // 0x490B30
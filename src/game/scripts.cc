@@ -5,6 +5,8 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
+
 #include "game/actions.h"
 #include "game/automap.h"
 #include "game/combat.h"
@@ -30,6 +32,7 @@
 #include "plib/gnw/input.h"
 #include "plib/gnw/intrface.h"
 #include "plib/gnw/memory.h"
+#include "plib/gnw/vcr.h"
 
 namespace fallout {
 
@@ -41,6 +44,16 @@ namespace fallout {
 
 #define SCRIPT_LIST_EXTENT_SIZE 16
 
+// The initial number of slots in [scr_index]. Must be a power of two.
+#define SCRIPT_INDEX_INITIAL_CAPACITY 256
+
+// Size of the square block of hexes covered by one spatial grid cell.
+#define SCRIPT_SPATIAL_CELL_SIZE 8
+
+#define SCRIPT_SPATIAL_GRID_WIDTH ((HEX_GRID_WIDTH + SCRIPT_SPATIAL_CELL_SIZE - 1) / SCRIPT_SPATIAL_CELL_SIZE)
+#define SCRIPT_SPATIAL_GRID_HEIGHT ((HEX_GRID_HEIGHT + SCRIPT_SPATIAL_CELL_SIZE - 1) / SCRIPT_SPATIAL_CELL_SIZE)
+#define SCRIPT_SPATIAL_GRID_SIZE (SCRIPT_SPATIAL_GRID_WIDTH * SCRIPT_SPATIAL_GRID_HEIGHT)
+
 typedef struct ScriptListExtent {
     Script scripts[SCRIPT_LIST_EXTENT_SIZE];
     // Number of scripts in the extent
@@ -56,6 +69,15 @@ typedef struct ScriptList {
     int nextScriptId;
 } ScriptList;
 
+typedef struct ScriptIndexEntry {
+    // SID of the script, -1 if slot is empty.
+    int sid;
+
+    // Location of the script in [scriptlists].
+    ScriptListExtent* extent;
+    int index;
+} ScriptIndexEntry;
+
 typedef struct ScriptState {
     unsigned int requests;
     STRUCT_664980 combatState1;
@@ -83,6 +105,15 @@ static int scr_write_ScriptNode(ScriptListExtent* a1, DB_FILE* stream);
 static int scr_read_ScriptSubNode(Script* scr, DB_FILE* stream);
 static int scr_read_ScriptNode(ScriptListExtent* a1, DB_FILE* stream);
 static int scr_new_id(int scriptType);
+static int scr_index_find(int sid);
+static bool scr_index_rebuild();
+static void scr_index_clear();
+static void scr_index_add(ScriptListExtent* extent, int index);
+static void scr_index_update(ScriptListExtent* extent, int index);
+static void scr_index_remove(int sid);
+static bool scr_spatial_grid_bounds(Script* script, int* elevationPtr, int* minXPtr, int* minYPtr, int* maxXPtr, int* maxYPtr);
+static bool scr_spatial_grid_rebuild();
+static void scr_spatial_fire(Script* script, Object* object, int tile, int built_tile);
 static void scrExecMapProcScripts(int a1);
 
 // Number of lines in scripts.lst
@@ -105,6 +136,33 @@ static bool scrSpatialsEnabled = true;
 // 0x507860
 static ScriptList scriptlists[SCRIPT_TYPE_COUNT];
 
+// Open-addressing hash table (linear probing) of scripts in [scriptlists] by
+// SID. When `NULL` lookups fall back to scanning script lists.
+static ScriptIndexEntry* scr_index = NULL;
+
+// The capacity of [scr_index], always a power of two.
+static int scr_index_capacity = 0;
+
+// The number of used slots in [scr_index].
+static int scr_index_length = 0;
+
+// Spatial scripts bucketed by elevation and grid cell their trigger area
+// intersects. Cell `i` on elevation `e` holds SIDs from
+// `scr_spatial_cell_start[e][i]` up to `scr_spatial_cell_start[e][i + 1]` in
+// [scr_spatial_cell_sids], in [scriptlists] order.
+static int scr_spatial_cell_start[ELEVATION_COUNT][SCRIPT_SPATIAL_GRID_SIZE + 1];
+static int* scr_spatial_cell_sids = NULL;
+static int scr_spatial_cell_sids_capacity = 0;
+
+// Set when spatial scripts are added, removed or reordered, the grid is
+// rebuilt on the next [scr_chk_spatials_in].
+static bool scr_spatial_grid_dirty = true;
+
+// Copy of cell contents being processed by [scr_chk_spatials_in], spatial
+// procs are free to modify script lists.
+static int* scr_spatial_candidates = NULL;
+static int scr_spatial_candidates_capacity = 0;
+
 // 0x5078B0
 static char script_path_base[] = "scripts\\";
 
@@ -428,12 +486,19 @@ int new_obj_id()
 // 0x491C00
 int scr_find_sid_from_program(Program* program)
 {
+    // Try SID remembered when program was attached to script first.
+    Script* script;
+    if (scr_ptr(program->sid, &script) != -1 && script->program == program) {
+        return program->sid;
+    }
+
     for (int type = 0; type < SCRIPT_TYPE_COUNT; type++) {
         ScriptListExtent* extent = scriptlists[type].head;
         while (extent != NULL) {
             for (int index = 0; index < extent->length; index++) {
-                Script* script = &(extent->scripts[index]);
+                script = &(extent->scripts[index]);
                 if (script->program == program) {
+                    program->sid = script->scr_id;
                     return script->scr_id;
                 }
             }
@@ -1068,6 +1133,8 @@ int exec_script_proc(int sid, int action)
         return -1;
     }
 
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_SCRIPT);
+
     Script* script;
     if (scr_ptr(sid, &script) == -1) {
         return -1;
@@ -1094,6 +1161,8 @@ int exec_script_proc(int sid, int action)
             return -1;
         }
 
+        script->program->sid = sid;
+
         programLoaded = true;
         script->scr_flags |= SCRIPT_FLAG_0x01;
     }
@@ -1440,6 +1509,18 @@ int scr_exit()
     interpretClose();
     clearPrograms();
 
+    if (scr_spatial_cell_sids != NULL) {
+        mem_free(scr_spatial_cell_sids);
+        scr_spatial_cell_sids = NULL;
+        scr_spatial_cell_sids_capacity = 0;
+    }
+
+    if (scr_spatial_candidates != NULL) {
+        mem_free(scr_spatial_candidates);
+        scr_spatial_candidates = NULL;
+        scr_spatial_candidates_capacity = 0;
+    }
+
     remove_bk_process(doBkProcesses);
 
     // NOTE: Uninline.
@@ -1612,6 +1693,9 @@ static int scr_header_load()
         scriptList->nextScriptId = 0;
     }
 
+    scr_index_clear();
+    scr_spatial_grid_dirty = true;
+
     return 0;
 }
 
@@ -1724,6 +1808,13 @@ int scr_save(DB_FILE* stream)
                         memcpy(script, &(lastScriptExtent->scripts[backwardsIndex]), sizeof(Script));
                         memcpy(&(lastScriptExtent->scripts[backwardsIndex]), &temp, sizeof(Script));
 
+                        scr_index_update(scriptExtent, index);
+                        scr_index_update(lastScriptExtent, backwardsIndex);
+
+                        if (scriptType == SCRIPT_TYPE_SPATIAL) {
+                            scr_spatial_grid_dirty = true;
+                        }
+
                         scriptCount++;
                     }
                 }
@@ -1842,6 +1933,8 @@ static int scr_read_ScriptNode(ScriptListExtent* scriptExtent, DB_FILE* stream)
 // 0x493DF4
 int scr_load(DB_FILE* stream)
 {
+    scr_index_clear();
+
     for (int index = 0; index < SCRIPT_TYPE_COUNT; index++) {
         ScriptList* scriptList = &(scriptlists[index]);
 
@@ -1913,6 +2006,9 @@ int scr_load(DB_FILE* stream)
         }
     }
 
+    scr_index_rebuild();
+    scr_spatial_grid_dirty = true;
+
     return 0;
 }
 
@@ -1930,6 +2026,23 @@ int scr_ptr(int sid, Script** scriptPtr)
         return -1;
     }
 
+    if (scr_index != NULL) {
+        int slot = scr_index_find(sid);
+        if (slot == -1) {
+            return -1;
+        }
+
+        ScriptIndexEntry* entry = &(scr_index[slot]);
+        Script* script = &(entry->extent->scripts[entry->index]);
+        if (script->scr_id == sid) {
+            *scriptPtr = script;
+            return 0;
+        }
+
+        // Index is out of sync, fall back to full scan.
+        debug_printf("\nERROR: scr_ptr: script index mismatch for %d", sid);
+    }
+
     ScriptList* scriptList = &(scriptlists[SID_TYPE(sid)]);
     ScriptListExtent* scriptListExtent = scriptList->head;
 
@@ -1947,6 +2060,178 @@ int scr_ptr(int sid, Script** scriptPtr)
     return -1;
 }
 
+// Changes SID of existing script.
+void scr_set_id(Script* script, int sid)
+{
+    if (scr_index != NULL) {
+        // Script contents might have been overwritten, so its old SID is
+        // not reliable. Find index entry by location instead.
+        for (int slot = 0; slot < scr_index_capacity; slot++) {
+            ScriptIndexEntry* entry = &(scr_index[slot]);
+            if (entry->sid != -1 && &(entry->extent->scripts[entry->index]) == script) {
+                ScriptListExtent* extent = entry->extent;
+                int index = entry->index;
+
+                scr_index_remove(entry->sid);
+
+                if (SID_TYPE(entry->sid) == SCRIPT_TYPE_SPATIAL || SID_TYPE(sid) == SCRIPT_TYPE_SPATIAL) {
+                    scr_spatial_grid_dirty = true;
+                }
+
+                script->scr_id = sid;
+                scr_index_add(extent, index);
+                return;
+            }
+        }
+    }
+
+    script->scr_id = sid;
+}
+
+// Returns slot of [scr_index] occupied by `sid`, or -1 if there is no such
+// script.
+static int scr_index_find(int sid)
+{
+    int mask = scr_index_capacity - 1;
+    int slot = ((unsigned int)sid * 2654435761U) & mask;
+    while (scr_index[slot].sid != -1) {
+        if (scr_index[slot].sid == sid) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+// Recreates [scr_index] from [scriptlists].
+static bool scr_index_rebuild()
+{
+    int length = 0;
+    for (int scriptType = 0; scriptType < SCRIPT_TYPE_COUNT; scriptType++) {
+        ScriptListExtent* extent = scriptlists[scriptType].head;
+        while (extent != NULL) {
+            length += extent->length;
+            extent = extent->next;
+        }
+    }
+
+    int capacity = SCRIPT_INDEX_INITIAL_CAPACITY;
+    while (capacity < length * 2 + 2) {
+        capacity *= 2;
+    }
+
+    scr_index_clear();
+
+    scr_index = (ScriptIndexEntry*)mem_malloc(sizeof(*scr_index) * capacity);
+    if (scr_index == NULL) {
+        return false;
+    }
+
+    for (int slot = 0; slot < capacity; slot++) {
+        scr_index[slot].sid = -1;
+    }
+
+    scr_index_capacity = capacity;
+
+    for (int scriptType = 0; scriptType < SCRIPT_TYPE_COUNT; scriptType++) {
+        ScriptListExtent* extent = scriptlists[scriptType].head;
+        while (extent != NULL) {
+            for (int index = 0; index < extent->length; index++) {
+                scr_index_add(extent, index);
+            }
+            extent = extent->next;
+        }
+    }
+
+    return true;
+}
+
+static void scr_index_clear()
+{
+    if (scr_index != NULL) {
+        mem_free(scr_index);
+        scr_index = NULL;
+    }
+
+    scr_index_capacity = 0;
+    scr_index_length = 0;
+}
+
+// Adds script at the specified location to [scr_index].
+static void scr_index_add(ScriptListExtent* extent, int index)
+{
+    if (scr_index == NULL) {
+        // Rebuilding picks up this script as well.
+        scr_index_rebuild();
+        return;
+    }
+
+    if ((scr_index_length + 1) * 2 > scr_index_capacity) {
+        scr_index_rebuild();
+        return;
+    }
+
+    int sid = extent->scripts[index].scr_id;
+    int mask = scr_index_capacity - 1;
+    int slot = ((unsigned int)sid * 2654435761U) & mask;
+    while (scr_index[slot].sid != -1) {
+        if (scr_index[slot].sid == sid) {
+            // Duplicate SID, keep the first one just like list scan does.
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    scr_index[slot].sid = sid;
+    scr_index[slot].extent = extent;
+    scr_index[slot].index = index;
+    scr_index_length++;
+}
+
+// Updates location of script that has been moved to the specified location.
+static void scr_index_update(ScriptListExtent* extent, int index)
+{
+    if (scr_index == NULL) {
+        return;
+    }
+
+    int slot = scr_index_find(extent->scripts[index].scr_id);
+    if (slot != -1) {
+        scr_index[slot].extent = extent;
+        scr_index[slot].index = index;
+    }
+}
+
+static void scr_index_remove(int sid)
+{
+    if (scr_index == NULL) {
+        return;
+    }
+
+    int slot = scr_index_find(sid);
+    if (slot == -1) {
+        return;
+    }
+
+    // Backward shift deletion, keeps probe sequences intact without
+    // tombstones.
+    int mask = scr_index_capacity - 1;
+    int hole = slot;
+    int next = (hole + 1) & mask;
+    while (scr_index[next].sid != -1) {
+        int home = ((unsigned int)scr_index[next].sid * 2654435761U) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            scr_index[hole] = scr_index[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    scr_index[hole].sid = -1;
+    scr_index_length--;
+}
+
 // 0x494080
 static int scr_new_id(int scriptType)
 {
@@ -2031,6 +2316,14 @@ int scr_new(int* sidPtr, int scriptType)
 
     scriptListExtent->length++;
 
+    scr_index_add(scriptListExtent, scriptListExtent->length - 1);
+
+    // Trigger area is usually assigned right after creation, the grid picks
+    // it up when rebuilt.
+    if (scriptType == SCRIPT_TYPE_SPATIAL) {
+        scr_spatial_grid_dirty = true;
+    }
+
     return 0;
 }
 
@@ -2125,6 +2418,12 @@ int scr_remove(int sid)
             debug_printf("\nERROR Removing Timed Events on scr_remove!!\n");
         }
 
+        scr_index_remove(sid);
+
+        if (SID_TYPE(sid) == SCRIPT_TYPE_SPATIAL) {
+            scr_spatial_grid_dirty = true;
+        }
+
         if (scriptListExtent == scriptList->tail && index + 1 == scriptListExtent->length) {
             // Removing last script in tail extent
             scriptListExtent->length -= 1;
@@ -2148,6 +2447,7 @@ int scr_remove(int sid)
         } else {
             // Relocate last script from tail extent into this script's slot.
             memcpy(&(scriptListExtent->scripts[index]), &(scriptList->tail->scripts[scriptList->tail->length - 1]), sizeof(Script));
+            scr_index_update(scriptListExtent, index);
 
             // Decrement number of scripts in tail extent.
             scriptList->tail->length -= 1;
@@ -2237,6 +2537,9 @@ int scr_remove_all_force()
         scriptList->length = 0;
     }
 
+    scr_index_clear();
+    scr_spatial_grid_dirty = true;
+
     scr_find_first_idx = 0;
     scr_find_first_ptr = 0;
     scr_find_first_elev = 0;
@@ -2357,22 +2660,50 @@ bool scr_chk_spatials_in(Object* object, int tile, int elevation)
 
     built_tile = builtTileCreate(tile, elevation);
 
-    script = scr_find_first_at(elevation);
-    while (script != NULL) {
-        if (built_tile == script->sp.built_tile) {
-            // NOTE: Uninline.
-            scr_set_objs(script->scr_id, object, NULL);
-            exec_script_proc(script->scr_id, SCRIPT_PROC_SPATIAL);
-        } else {
-            if (script->sp.radius != 0) {
-                if (tile_in_tile_bound(builtTileGetTile(script->sp.built_tile), script->sp.radius, tile)) {
-                    // NOTE: Uninline.
-                    scr_set_objs(script->scr_id, object, NULL);
-                    exec_script_proc(script->scr_id, SCRIPT_PROC_SPATIAL);
+    if (scr_spatial_grid_dirty) {
+        scr_spatial_grid_dirty = !scr_spatial_grid_rebuild();
+    }
+
+    if (!scr_spatial_grid_dirty && elevation >= 0 && elevation < ELEVATION_COUNT && tile < HEX_GRID_SIZE) {
+        int cell = (tile / HEX_GRID_WIDTH / SCRIPT_SPATIAL_CELL_SIZE) * SCRIPT_SPATIAL_GRID_WIDTH + (tile % HEX_GRID_WIDTH / SCRIPT_SPATIAL_CELL_SIZE);
+        int start = scr_spatial_cell_start[elevation][cell];
+        int length = scr_spatial_cell_start[elevation][cell + 1] - start;
+
+        if (length > scr_spatial_candidates_capacity) {
+            int* candidates = (int*)mem_realloc(scr_spatial_candidates, sizeof(*candidates) * length);
+            if (candidates == NULL) {
+                length = -1;
+            } else {
+                scr_spatial_candidates = candidates;
+                scr_spatial_candidates_capacity = length;
+            }
+        }
+
+        if (length != -1) {
+            if (length > 0) {
+                memcpy(scr_spatial_candidates, scr_spatial_cell_sids + start, sizeof(*scr_spatial_candidates) * length);
+            }
+
+            for (int index = 0; index < length; index++) {
+                if (scr_ptr(scr_spatial_candidates[index], &script) == -1) {
+                    continue;
+                }
+
+                // Same filter as in [scr_find_next_at].
+                if ((script->scr_flags & SCRIPT_FLAG_0x02) == 0 && builtTileGetElevation(script->sp.built_tile) == elevation) {
+                    scr_spatial_fire(script, object, tile, built_tile);
                 }
             }
+
+            scr_spatials_enable();
+
+            return true;
         }
+    }
 
+    script = scr_find_first_at(elevation);
+    while (script != NULL) {
+        scr_spatial_fire(script, object, tile, built_tile);
         script = scr_find_next_at();
     }
 
@@ -2381,6 +2712,134 @@ bool scr_chk_spatials_in(Object* object, int tile, int elevation)
     return true;
 }
 
+// Executes spatial proc of `script` if `tile` is within its trigger area.
+static void scr_spatial_fire(Script* script, Object* object, int tile, int built_tile)
+{
+    if (built_tile == script->sp.built_tile) {
+        // NOTE: Uninline.
+        scr_set_objs(script->scr_id, object, NULL);
+        exec_script_proc(script->scr_id, SCRIPT_PROC_SPATIAL);
+    } else {
+        if (script->sp.radius != 0) {
+            if (tile_in_tile_bound(builtTileGetTile(script->sp.built_tile), script->sp.radius, tile)) {
+                // NOTE: Uninline.
+                scr_set_objs(script->scr_id, object, NULL);
+                exec_script_proc(script->scr_id, SCRIPT_PROC_SPATIAL);
+            }
+        }
+    }
+}
+
+// Calculates range of grid cells that can contain tiles triggering
+// `script`. Every step of [tile_dist] changes hex column and row by at most
+// one, so trigger area fits into square of `radius` hexes around its center.
+static bool scr_spatial_grid_bounds(Script* script, int* elevationPtr, int* minXPtr, int* minYPtr, int* maxXPtr, int* maxYPtr)
+{
+    int elevation = builtTileGetElevation(script->sp.built_tile);
+    if (elevation < 0 || elevation >= ELEVATION_COUNT) {
+        return false;
+    }
+
+    *elevationPtr = elevation;
+
+    int tile = builtTileGetTile(script->sp.built_tile);
+    if (tile < 0 || tile >= HEX_GRID_SIZE) {
+        // Can't reason about distances from invalid tile, let it be tested
+        // everywhere.
+        *minXPtr = 0;
+        *minYPtr = 0;
+        *maxXPtr = SCRIPT_SPATIAL_GRID_WIDTH - 1;
+        *maxYPtr = SCRIPT_SPATIAL_GRID_HEIGHT - 1;
+        return true;
+    }
+
+    int radius = script->sp.radius > 0 ? script->sp.radius : 0;
+    int x = tile % HEX_GRID_WIDTH;
+    int y = tile / HEX_GRID_WIDTH;
+
+    *minXPtr = std::max(x - radius, 0) / SCRIPT_SPATIAL_CELL_SIZE;
+    *minYPtr = std::max(y - radius, 0) / SCRIPT_SPATIAL_CELL_SIZE;
+    *maxXPtr = std::min(x + radius, HEX_GRID_WIDTH - 1) / SCRIPT_SPATIAL_CELL_SIZE;
+    *maxYPtr = std::min(y + radius, HEX_GRID_HEIGHT - 1) / SCRIPT_SPATIAL_CELL_SIZE;
+
+    return true;
+}
+
+// Rebuilds spatial scripts grid from [scriptlists]. Returns `false` if grid
+// cannot be allocated, spatial checks use list scan in this case.
+static bool scr_spatial_grid_rebuild()
+{
+    // First pass counts entries in every cell, second one fills them.
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 0) {
+            memset(scr_spatial_cell_start, 0, sizeof(scr_spatial_cell_start));
+        }
+
+        ScriptListExtent* extent = scriptlists[SCRIPT_TYPE_SPATIAL].head;
+        while (extent != NULL) {
+            for (int index = 0; index < extent->length; index++) {
+                Script* script = &(extent->scripts[index]);
+
+                int elevation;
+                int minX;
+                int minY;
+                int maxX;
+                int maxY;
+                if (!scr_spatial_grid_bounds(script, &elevation, &minX, &minY, &maxX, &maxY)) {
+                    continue;
+                }
+
+                for (int y = minY; y <= maxY; y++) {
+                    for (int x = minX; x <= maxX; x++) {
+                        int cell = y * SCRIPT_SPATIAL_GRID_WIDTH + x;
+                        if (pass == 0) {
+                            scr_spatial_cell_start[elevation][cell + 1]++;
+                        } else {
+                            // Start of each cell is used as fill cursor and
+                            // restored afterwards.
+                            scr_spatial_cell_sids[scr_spatial_cell_start[elevation][cell]++] = script->scr_id;
+                        }
+                    }
+                }
+            }
+            extent = extent->next;
+        }
+
+        if (pass == 0) {
+            // Convert counts to offsets, elevations share one array.
+            int total = 0;
+            for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+                for (int cell = 0; cell < SCRIPT_SPATIAL_GRID_SIZE; cell++) {
+                    int count = scr_spatial_cell_start[elevation][cell + 1];
+                    scr_spatial_cell_start[elevation][cell] = total;
+                    total += count;
+                }
+                scr_spatial_cell_start[elevation][SCRIPT_SPATIAL_GRID_SIZE] = total;
+            }
+
+            if (total > scr_spatial_cell_sids_capacity) {
+                int* sids = (int*)mem_realloc(scr_spatial_cell_sids, sizeof(*sids) * total);
+                if (sids == NULL) {
+                    return false;
+                }
+
+                scr_spatial_cell_sids = sids;
+                scr_spatial_cell_sids_capacity = total;
+            }
+        }
+    }
+
+    // Every cell's start now points to the start of the next one.
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int cell = SCRIPT_SPATIAL_GRID_SIZE - 1; cell > 0; cell--) {
+            scr_spatial_cell_start[elevation][cell] = scr_spatial_cell_start[elevation][cell - 1];
+        }
+        scr_spatial_cell_start[elevation][0] = elevation > 0 ? scr_spatial_cell_start[elevation - 1][SCRIPT_SPATIAL_GRID_SIZE] : 0;
+    }
+
+    return true;
+}
+
 // 0x4948F8
 bool tile_in_tile_bound(int tile1, int radius, int tile2)
 {
@@ -191,6 +191,7 @@ int scr_game_load2(DB_FILE* stream);
 int scr_save(DB_FILE* stream);
 int scr_load(DB_FILE* stream);
 int scr_ptr(int sid, Script** script);
+void scr_set_id(Script* script, int sid);
 int scr_new(int* sidPtr, int scriptType);
 int scr_remove_local_vars(Script* script);
 int scr_remove(int index);
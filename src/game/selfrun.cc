@@ -92,6 +92,10 @@ void selfrun_playback_loop(SelfrunData* selfrunData)
         char path[COMPAT_MAX_PATH];
         snprintf(path, sizeof(path), "%s%s", "selfrun\\", selfrunData->recordingFileName);
 
+        bool fastForward = false;
+        configGetBool(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_SELFRUN_FAST_FORWARD_KEY, &fastForward);
+        vcr_set_fast_forward(fastForward);
+
         if (vcr_play(path, VCR_TERMINATE_ON_KEY_PRESS | VCR_TERMINATE_ON_MOUSE_PRESS, selfrun_playback_callback)) {
             bool cursorWasHidden = mouse_hidden();
             if (cursorWasHidden) {
@@ -7,6 +7,13 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include "game/cache.h"
 #include "game/config.h"
 #include "game/gconfig.h"
 #include "game/gmouse.h"
@@ -18,11 +25,32 @@
 #include "plib/gnw/debug.h"
 #include "plib/gnw/grbuf.h"
 #include "plib/gnw/input.h"
+#include "plib/gnw/memory.h"
+#include "plib/gnw/vcr.h"
 
 namespace fallout {
 
 #define TILE_IS_VALID(tile) ((tile) >= 0 && (tile) < grid_size)
 
+// Number of floor tile vertices with individual light intensity.
+#define FLOOR_VERTEX_COUNT 10
+
+// Maximum size of lit floor tiles cache.
+#define FLOOR_LIGHT_CACHE_SIZE (2 << 20)
+
+// Maximum number of threads rendering floor of one refresh.
+#define TILE_RENDER_MAX_THREADS 8
+
+// Minimum height of floor band worth a separate thread.
+#define TILE_RENDER_MIN_BAND_HEIGHT 64
+
+// Width and height of chunk of pre-rendered floor layer.
+#define FLOOR_LAYER_CHUNK_SIZE 128
+
+// Distance (in pixels) from hex to the farthest floor pixel lit by it.
+#define FLOOR_LAYER_LIGHT_REACH_X 160
+#define FLOOR_LAYER_LIGHT_REACH_Y 96
+
 typedef struct RightsideUpTableEntry {
     int field_0;
     int field_4;
@@ -51,12 +79,33 @@ typedef struct UpsideDownTriangle {
     int field_8;
 } UpsideDownTriangle;
 
+typedef struct FloorLayerChunk {
+    unsigned char* data;
+    bool valid;
+} FloorLayerChunk;
+
 static void refresh_mapper(Rect* rect, int elevation);
 static void refresh_game(Rect* rect, int elevation);
+static void square_render_floor_banded(Rect* rect, int elevation);
+static void floor_workers_init();
+static void floor_workers_exit();
+static void floor_worker_run(int index);
+static void floor_lock();
+static void floor_unlock();
+static bool floor_layer_init();
+static void floor_layer_exit();
+static void floor_layer_origin(int* x, int* y);
+static void floor_layer_invalidate_rect(int elevation, Rect* rect);
+static bool floor_layer_render_chunk(FloorLayerChunk* chunk, int column, int row, int elevation);
+static void floor_layer_render(Rect* rect, int elevation);
 static bool tile_on_edge(int tile);
 static void roof_fill_on(int x, int y, int elevation);
 static void roof_fill_off(int x, int y, int elevation);
 static void roof_draw(int fid, int x, int y, Rect* rect, int light);
+static int floor_light_cache_key(int fid, const int* intensities);
+static bool floor_light_cache_matches(unsigned char* data, int fid, const int* intensities);
+static int floor_light_cache_size(int key, int* sizePtr);
+static int floor_light_cache_read(int key, int* sizePtr, unsigned char* data);
 
 // 0x508330
 static bool borderInitialized = false;
@@ -165,8 +214,66 @@ static UpsideDownTriangle upside_down_triangles[5] = {
     { 6, 9, 7 },
 };
 
+// NOTE: Thread local since floor can be rendered by several threads (see
+// [square_render_floor_banded]).
+//
 // 0x665274
-static int intensity_map[3280];
+static thread_local int intensity_map[3280];
+
+// Header of lit floor tile in [floor_light_cache], followed by lit frame
+// pixels.
+typedef struct FloorLightCacheHeader {
+    int fid;
+    int intensities[FLOOR_VERTEX_COUNT];
+    int width;
+    int height;
+} FloorLightCacheHeader;
+
+// Floor tiles lit with non-uniform light, keyed by hash of fid and vertex
+// intensities (collisions are detected by comparing header).
+static Cache floor_light_cache;
+static bool floor_light_cache_initialized = false;
+
+// Tile being lit by [floor_draw], consumed by [floor_light_cache_read].
+static Art* floor_light_cache_art;
+static int floor_light_cache_fid;
+static const int* floor_light_cache_intensities;
+
+// Number of threads used to render floor, 1 disables banded rendering.
+static int render_threads = 1;
+
+// Guards art cache and [floor_light_cache] while floor is rendered by several
+// threads, see [floor_lock].
+static std::mutex floor_mutex;
+static bool floor_threaded = false;
+
+// Threads rendering floor bands other than the first one, started once in
+// [tile_init] and woken up for every banded refresh (see
+// [square_render_floor_banded]).
+static std::thread floor_workers[TILE_RENDER_MAX_THREADS - 1];
+static int floor_workers_count = 0;
+static std::mutex floor_workers_mutex;
+static std::condition_variable floor_workers_wakeup;
+static std::condition_variable floor_workers_done;
+static unsigned int floor_workers_generation = 0;
+static int floor_workers_pending = 0;
+static bool floor_workers_exiting = false;
+
+// Job of current banded refresh, guarded by [floor_workers_mutex].
+static Rect floor_bands[TILE_RENDER_MAX_THREADS];
+static int floor_bands_count = 0;
+static int floor_bands_elevation;
+
+// Pre-rendered floor of every elevation, copied to screen instead of drawing
+// floor tiles (see [floor_layer_render]). Canvas is in map coordinates (screen
+// coordinates relative to [floor_layer_origin]) and covers entire square grid.
+// Chunks are allocated and rendered on first use and invalidated when light
+// changes.
+static FloorLayerChunk* floor_layer_chunks[ELEVATION_COUNT];
+static bool floor_layer_enabled = false;
+static int floor_layer_top;
+static int floor_layer_columns;
+static int floor_layer_rows;
 
 // Deltas to perform tile calculations in given direction.
 //
@@ -423,6 +530,27 @@ int tile_init(TileData** a1, int squareGridWidth, int squareGridHeight, int hexG
         tile_refresh = refresh_mapper;
     }
 
+    // Zero means one thread per core.
+    int threads = 0;
+    config_get_value(&game_config, GAME_CONFIG_SYSTEM_KEY, GAME_CONFIG_RENDER_THREADS_KEY, &threads);
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    render_threads = std::min(std::max(threads, 1), TILE_RENDER_MAX_THREADS);
+    floor_workers_init();
+
+    // Lit tiles cache is optional, floor is drawn directly without it.
+    floor_light_cache_initialized = cache_init(&floor_light_cache, floor_light_cache_size, floor_light_cache_read, NULL, FLOOR_LIGHT_CACHE_SIZE);
+
+    // Floor layer is not used by mapper since it edits floor.
+    int floorLayer = 0;
+    config_get_value(&game_config, GAME_CONFIG_SYSTEM_KEY, GAME_CONFIG_FLOOR_LAYER_KEY, &floorLayer);
+    if (floorLayer != 0 && tile_refresh == refresh_game) {
+        if (!floor_layer_init()) {
+            debug_printf("tile_init: unable to allocate floor layer\n");
+        }
+    }
+
     return 0;
 }
 
@@ -455,11 +583,29 @@ void tile_set_border(int windowWidth, int windowHeight, int hexGridWidth, int he
 // 0x49DE80
 void tile_reset()
 {
+    // Intensity color table might have been changed.
+    if (floor_light_cache_initialized) {
+        cache_flush(&floor_light_cache);
+    }
+
+    tile_floor_layer_invalidate_all();
 }
 
 // 0x49DE80
 void tile_exit()
 {
+    floor_workers_exit();
+
+    if (floor_light_cache_initialized) {
+        char stats[200];
+        cache_stats(&floor_light_cache, stats, sizeof(stats));
+        debug_printf("Floor light %s", stats);
+
+        cache_exit(&floor_light_cache);
+        floor_light_cache_initialized = false;
+    }
+
+    floor_layer_exit();
 }
 
 // 0x49DE8C
@@ -607,7 +753,15 @@ static void refresh_game(Rect* rect, int elevation)
         buf_full,
         0);
 
-    square_render_floor(&rectToUpdate, elevation);
+    {
+        VcrProfileScope profileScope(VCR_PROFILE_SECTION_FLOOR);
+        if (floor_layer_enabled) {
+            floor_layer_render(&rectToUpdate, elevation);
+        } else {
+            square_render_floor_banded(&rectToUpdate, elevation);
+        }
+    }
+
     obj_render_pre_roof(&rectToUpdate, elevation);
     square_render_roof(&rectToUpdate, elevation);
     bounds_render(&rectToUpdate, elevation);
@@ -1436,6 +1590,401 @@ void square_render_floor(Rect* rect, int elevation)
     }
 }
 
+// Renders floor of large rects in horizontal bands on several threads. Bands
+// do not overlap and every band draws tiles in the same order, so result is
+// identical to [square_render_floor] of entire rect.
+static void square_render_floor_banded(Rect* rect, int elevation)
+{
+    int height = rect->lry - rect->uly + 1;
+    int bandsCount = std::min(render_threads, height / TILE_RENDER_MIN_BAND_HEIGHT);
+    if (bandsCount <= 1) {
+        square_render_floor(rect, elevation);
+        return;
+    }
+
+    floor_threaded = true;
+
+    std::unique_lock<std::mutex> lock(floor_workers_mutex);
+
+    int top = rect->uly;
+    for (int index = 0; index < bandsCount; index++) {
+        int bandHeight = height / bandsCount + (index < height % bandsCount ? 1 : 0);
+        floor_bands[index] = *rect;
+        floor_bands[index].uly = top;
+        floor_bands[index].lry = top + bandHeight - 1;
+        top += bandHeight;
+    }
+
+    floor_bands_count = bandsCount;
+    floor_bands_elevation = elevation;
+    floor_workers_pending = bandsCount - 1;
+    floor_workers_generation++;
+
+    lock.unlock();
+    floor_workers_wakeup.notify_all();
+
+    square_render_floor(&(floor_bands[0]), elevation);
+
+    lock.lock();
+    floor_workers_done.wait(lock, [] { return floor_workers_pending == 0; });
+    lock.unlock();
+
+    floor_threaded = false;
+}
+
+// Starts workers for [render_threads]. Threads which cannot be started are
+// not used, floor is rendered by fewer threads (or serially) instead.
+static void floor_workers_init()
+{
+    floor_workers_exiting = false;
+
+    for (int index = 0; index < render_threads - 1; index++) {
+        try {
+            floor_workers[index] = std::thread(floor_worker_run, index);
+        } catch (const std::system_error& e) {
+            debug_printf("floor_workers_init: unable to start thread: %s\n", e.what());
+            break;
+        }
+
+        floor_workers_count++;
+    }
+
+    render_threads = floor_workers_count + 1;
+
+    // Reported along with floor timings of fast-forward selfrun playback.
+    debug_printf("Floor rendered by %d thread(s)\n", render_threads);
+}
+
+static void floor_workers_exit()
+{
+    {
+        std::lock_guard<std::mutex> lock(floor_workers_mutex);
+        floor_workers_exiting = true;
+    }
+
+    floor_workers_wakeup.notify_all();
+
+    for (int index = 0; index < floor_workers_count; index++) {
+        floor_workers[index].join();
+    }
+
+    floor_workers_count = 0;
+    render_threads = 1;
+}
+
+// Worker `index` renders band `index + 1` of every banded refresh having
+// that many bands.
+static void floor_worker_run(int index)
+{
+    unsigned int generation = 0;
+
+    std::unique_lock<std::mutex> lock(floor_workers_mutex);
+    while (true) {
+        floor_workers_wakeup.wait(lock, [&generation] { return floor_workers_exiting || floor_workers_generation != generation; });
+        if (floor_workers_exiting) {
+            break;
+        }
+
+        generation = floor_workers_generation;
+        if (index + 1 >= floor_bands_count) {
+            continue;
+        }
+
+        Rect band = floor_bands[index + 1];
+        int elevation = floor_bands_elevation;
+
+        lock.unlock();
+        square_render_floor(&band, elevation);
+        lock.lock();
+
+        floor_workers_pending--;
+        if (floor_workers_pending == 0) {
+            floor_workers_done.notify_one();
+        }
+    }
+}
+
+// Art cache and [floor_light_cache] are not thread safe, accesses from
+// [floor_draw] are serialized while floor is rendered in bands.
+static void floor_lock()
+{
+    if (floor_threaded) {
+        floor_mutex.lock();
+    }
+}
+
+static void floor_unlock()
+{
+    if (floor_threaded) {
+        floor_mutex.unlock();
+    }
+}
+
+static bool floor_layer_init()
+{
+    // Floor tiles are 80x36 and drawn at [square_coord].
+    int width = 48 * (square_width - 1) + 32 * (square_length - 1) + 80;
+    int height = 12 * (square_width - 1) + 24 * (square_length - 1) + 36;
+
+    floor_layer_top = -12 * (square_width - 1);
+    floor_layer_columns = (width + FLOOR_LAYER_CHUNK_SIZE - 1) / FLOOR_LAYER_CHUNK_SIZE;
+    floor_layer_rows = (height + FLOOR_LAYER_CHUNK_SIZE - 1) / FLOOR_LAYER_CHUNK_SIZE;
+
+    size_t size = sizeof(FloorLayerChunk) * floor_layer_columns * floor_layer_rows;
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        floor_layer_chunks[elevation] = (FloorLayerChunk*)mem_malloc(size);
+        if (floor_layer_chunks[elevation] == NULL) {
+            floor_layer_exit();
+            return false;
+        }
+
+        memset(floor_layer_chunks[elevation], 0, size);
+    }
+
+    floor_layer_enabled = true;
+
+    return true;
+}
+
+static void floor_layer_exit()
+{
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        FloorLayerChunk* chunks = floor_layer_chunks[elevation];
+        if (chunks != NULL) {
+            for (int index = 0; index < floor_layer_columns * floor_layer_rows; index++) {
+                if (chunks[index].data != NULL) {
+                    mem_free(chunks[index].data);
+                }
+            }
+
+            mem_free(chunks);
+            floor_layer_chunks[elevation] = NULL;
+        }
+    }
+
+    floor_layer_enabled = false;
+}
+
+// Returns screen coordinates of floor layer origin, that is screen coordinates
+// of the last square of the first row (the leftmost one on screen) at current
+// scroll position.
+static void floor_layer_origin(int* x, int* y)
+{
+    *x = square_offx - 48 * square_x - 32 * square_y;
+    *y = square_offy + 12 * square_x - 24 * square_y;
+}
+
+void tile_floor_layer_invalidate_all()
+{
+    if (!floor_layer_enabled) {
+        return;
+    }
+
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int index = 0; index < floor_layer_columns * floor_layer_rows; index++) {
+            floor_layer_chunks[elevation][index].valid = false;
+        }
+    }
+}
+
+// Should be called when light intensity of `tile` is changed.
+void tile_floor_layer_invalidate_tile(int elevation, int tile)
+{
+    if (!floor_layer_enabled) {
+        return;
+    }
+
+    if (!elevationIsValid(elevation)) {
+        return;
+    }
+
+    int x;
+    int y;
+    if (tile_coord(tile, &x, &y, elevation) != 0) {
+        return;
+    }
+
+    int originX;
+    int originY;
+    floor_layer_origin(&originX, &originY);
+
+    Rect rect;
+    rect.ulx = x - originX - FLOOR_LAYER_LIGHT_REACH_X;
+    rect.uly = y - originY - FLOOR_LAYER_LIGHT_REACH_Y;
+    rect.lrx = x - originX + 32 + FLOOR_LAYER_LIGHT_REACH_X;
+    rect.lry = y - originY + 16 + FLOOR_LAYER_LIGHT_REACH_Y;
+    floor_layer_invalidate_rect(elevation, &rect);
+}
+
+// Invalidates chunks intersecting `rect` (in map coordinates).
+static void floor_layer_invalidate_rect(int elevation, Rect* rect)
+{
+    Rect canvasRect;
+    canvasRect.ulx = 0;
+    canvasRect.uly = floor_layer_top;
+    canvasRect.lrx = floor_layer_columns * FLOOR_LAYER_CHUNK_SIZE - 1;
+    canvasRect.lry = floor_layer_top + floor_layer_rows * FLOOR_LAYER_CHUNK_SIZE - 1;
+
+    Rect invalidRect;
+    if (rect_inside_bound(rect, &canvasRect, &invalidRect) == -1) {
+        return;
+    }
+
+    for (int row = (invalidRect.uly - floor_layer_top) / FLOOR_LAYER_CHUNK_SIZE; row <= (invalidRect.lry - floor_layer_top) / FLOOR_LAYER_CHUNK_SIZE; row++) {
+        FloorLayerChunk* chunks = floor_layer_chunks[elevation] + floor_layer_columns * row;
+        for (int column = invalidRect.ulx / FLOOR_LAYER_CHUNK_SIZE; column <= invalidRect.lrx / FLOOR_LAYER_CHUNK_SIZE; column++) {
+            chunks[column].valid = false;
+        }
+    }
+}
+
+// Renders floor into `chunk` by temporarily making it screen buffer scrolled
+// to chunk's position, so [floor_draw] produces exactly the same pixels.
+static bool floor_layer_render_chunk(FloorLayerChunk* chunk, int column, int row, int elevation)
+{
+    if (chunk->data == NULL) {
+        chunk->data = (unsigned char*)mem_malloc(FLOOR_LAYER_CHUNK_SIZE * FLOOR_LAYER_CHUNK_SIZE);
+        if (chunk->data == NULL) {
+            return false;
+        }
+    }
+
+    int originX;
+    int originY;
+    floor_layer_origin(&originX, &originY);
+
+    int dx = -(originX + column * FLOOR_LAYER_CHUNK_SIZE);
+    int dy = -(originY + floor_layer_top + row * FLOOR_LAYER_CHUNK_SIZE);
+
+    unsigned char* savedBuf = buf;
+    int savedBufWidth = buf_width;
+    int savedBufLength = buf_length;
+    int savedBufFull = buf_full;
+
+    buf = chunk->data;
+    buf_width = FLOOR_LAYER_CHUNK_SIZE;
+    buf_length = FLOOR_LAYER_CHUNK_SIZE;
+    buf_full = FLOOR_LAYER_CHUNK_SIZE;
+    square_offx += dx;
+    square_offy += dy;
+    tile_offx += dx;
+    tile_offy += dy;
+
+    buf_fill(buf, buf_width, buf_length, buf_full, 0);
+
+    Rect rect;
+    rect.ulx = 0;
+    rect.uly = 0;
+    rect.lrx = FLOOR_LAYER_CHUNK_SIZE - 1;
+    rect.lry = FLOOR_LAYER_CHUNK_SIZE - 1;
+
+    // Same squares range as in [square_render_floor], extended by one square
+    // to catch tiles sticking into chunk from its corners.
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+    int temp;
+    square_xy(rect.ulx, rect.uly, elevation, &temp, &minY);
+    square_xy(rect.lrx, rect.uly, elevation, &minX, &temp);
+    square_xy(rect.ulx, rect.lry, elevation, &maxX, &temp);
+    square_xy(rect.lrx, rect.lry, elevation, &temp, &maxY);
+
+    minX = std::max(minX - 1, 0);
+    minY = std::max(minY - 1, 0);
+    maxX = std::min(maxX + 1, square_width - 1);
+    maxY = std::min(maxY + 1, square_length - 1);
+
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            int squareTile = square_width * y + x;
+            int frmId = squares[elevation]->field_0[squareTile];
+            if ((((frmId & 0xF000) >> 12) & 0x01) == 0) {
+                int tileScreenX;
+                int tileScreenY;
+                square_coord(squareTile, &tileScreenX, &tileScreenY, elevation);
+                int fid = art_id(OBJ_TYPE_TILE, frmId & 0xFFF, 0, 0, 0);
+                floor_draw(fid, tileScreenX, tileScreenY, &rect);
+            }
+        }
+    }
+
+    buf = savedBuf;
+    buf_width = savedBufWidth;
+    buf_length = savedBufLength;
+    buf_full = savedBufFull;
+    square_offx -= dx;
+    square_offy -= dy;
+    tile_offx -= dx;
+    tile_offy -= dy;
+
+    chunk->valid = true;
+
+    return true;
+}
+
+// Copies floor from pre-rendered layer, rendering missing chunks. Result is
+// the same as [square_render_floor] on zero-filled buffer.
+static void floor_layer_render(Rect* rect, int elevation)
+{
+    // Bounds depend on center tile, so they are applied when copying rather
+    // than when rendering chunks.
+    Rect constrainedRect = *rect;
+    if (tile_inside_bound(&constrainedRect) != 0) {
+        return;
+    }
+
+    int originX;
+    int originY;
+    floor_layer_origin(&originX, &originY);
+
+    Rect canvasRect;
+    canvasRect.ulx = originX;
+    canvasRect.uly = originY + floor_layer_top;
+    canvasRect.lrx = canvasRect.ulx + floor_layer_columns * FLOOR_LAYER_CHUNK_SIZE - 1;
+    canvasRect.lry = canvasRect.uly + floor_layer_rows * FLOOR_LAYER_CHUNK_SIZE - 1;
+
+    if (rect_inside_bound(&constrainedRect, &canvasRect, &constrainedRect) == -1) {
+        return;
+    }
+
+    int minColumn = (constrainedRect.ulx - canvasRect.ulx) / FLOOR_LAYER_CHUNK_SIZE;
+    int maxColumn = (constrainedRect.lrx - canvasRect.ulx) / FLOOR_LAYER_CHUNK_SIZE;
+    int minRow = (constrainedRect.uly - canvasRect.uly) / FLOOR_LAYER_CHUNK_SIZE;
+    int maxRow = (constrainedRect.lry - canvasRect.uly) / FLOOR_LAYER_CHUNK_SIZE;
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int column = minColumn; column <= maxColumn; column++) {
+            Rect chunkRect;
+            chunkRect.ulx = canvasRect.ulx + column * FLOOR_LAYER_CHUNK_SIZE;
+            chunkRect.uly = canvasRect.uly + row * FLOOR_LAYER_CHUNK_SIZE;
+            chunkRect.lrx = chunkRect.ulx + FLOOR_LAYER_CHUNK_SIZE - 1;
+            chunkRect.lry = chunkRect.uly + FLOOR_LAYER_CHUNK_SIZE - 1;
+
+            Rect part;
+            if (rect_inside_bound(&constrainedRect, &chunkRect, &part) == -1) {
+                continue;
+            }
+
+            FloorLayerChunk* chunk = &(floor_layer_chunks[elevation][floor_layer_columns * row + column]);
+            if (!chunk->valid) {
+                if (!floor_layer_render_chunk(chunk, column, row, elevation)) {
+                    // Out of memory, draw this part directly.
+                    square_render_floor(&part, elevation);
+                    continue;
+                }
+            }
+
+            buf_to_buf(chunk->data + FLOOR_LAYER_CHUNK_SIZE * (part.uly - chunkRect.uly) + (part.ulx - chunkRect.ulx),
+                part.lrx - part.ulx + 1,
+                part.lry - part.uly + 1,
+                FLOOR_LAYER_CHUNK_SIZE,
+                buf + buf_full * part.uly + part.ulx,
+                buf_full);
+        }
+    }
+}
+
 // 0x49F5B4
 bool square_roof_intersect(int x, int y, int elevation)
 {
@@ -1593,7 +2142,9 @@ void floor_draw(int fid, int x, int y, Rect* rect)
     }
 
     CacheEntry* cacheEntry;
+    floor_lock();
     Art* art = art_ptr_lock(fid, &cacheEntry);
+    floor_unlock();
     if (art == NULL) {
         return;
     }
@@ -1667,6 +2218,7 @@ void floor_draw(int fid, int x, int y, Rect* rect)
     if (tile != -1) {
         int parity = tile & 1;
         int ambientIntensity = light_get_ambient();
+        int intensities[FLOOR_VERTEX_COUNT];
         for (int i = 0; i < 10; i++) {
             // NOTE: calling light_get_tile two times, probably a result of using __min kind macro
             int tileIntensity = light_get_tile(elev, tile + verticies[i].offsets[parity]);
@@ -1674,12 +2226,12 @@ void floor_draw(int fid, int x, int y, Rect* rect)
                 tileIntensity = ambientIntensity;
             }
 
-            verticies[i].intensity = tileIntensity;
+            intensities[i] = tileIntensity;
         }
 
         int v23 = 0;
         for (int i = 0; i < 9; i++) {
-            if (verticies[i + 1].intensity != verticies[i].intensity) {
+            if (intensities[i + 1] != intensities[i]) {
                 break;
             }
 
@@ -1688,18 +2240,59 @@ void floor_draw(int fid, int x, int y, Rect* rect)
 
         if (v23 == 9) {
             unsigned char* frame_data = art_frame_data(art, 0, 0);
-            dark_trans_buf_to_buf(frame_data + frameWidth * v78 + v79, v77, v76, frameWidth, buf, x, y, buf_full, verticies[0].intensity);
+            dark_trans_buf_to_buf(frame_data + frameWidth * v78 + v79, v77, v76, frameWidth, buf, x, y, buf_full, intensities[0]);
             goto out;
         }
 
+        // Only tiles which fit into [intensity_map] can be cached.
+        bool cacheable = floor_light_cache_initialized
+            && frameWidth <= 80
+            && 160 + 80 * frameHeight <= (int)(sizeof(intensity_map) / sizeof(intensity_map[0]));
+
+        int cacheKey = 0;
+        if (cacheable) {
+            cacheKey = floor_light_cache_key(fid, intensities);
+
+            unsigned char* data = NULL;
+            CacheEntry* lightCacheEntry;
+            floor_lock();
+            if (cache_query(&floor_light_cache, cacheKey)) {
+                if (cache_lock(&floor_light_cache, cacheKey, (void**)&data, &lightCacheEntry)) {
+                    if (!floor_light_cache_matches(data, fid, intensities)) {
+                        // Other tile with the same hash, replace it.
+                        cache_unlock(&floor_light_cache, lightCacheEntry);
+                        cache_discard(&floor_light_cache, cacheKey);
+                        data = NULL;
+                    }
+                }
+            }
+            floor_unlock();
+
+            if (data != NULL) {
+                mask_buf_to_buf(data + sizeof(FloorLightCacheHeader) + frameWidth * v78 + v79,
+                    v77,
+                    v76,
+                    frameWidth,
+                    art_frame_data(art, 0, 0) + frameWidth * v78 + v79,
+                    frameWidth,
+                    buf + buf_full * y + x,
+                    buf_full);
+
+                floor_lock();
+                cache_unlock(&floor_light_cache, lightCacheEntry);
+                floor_unlock();
+                goto out;
+            }
+        }
+
         for (int i = 0; i < 5; i++) {
             RightsideUpTriangle* triangle = &(rightside_up_triangles[i]);
-            int v32 = verticies[triangle->field_8].intensity;
+            int v32 = intensities[triangle->field_8];
             int v33 = verticies[triangle->field_8].field_0;
-            int v34 = verticies[triangle->field_4].intensity - verticies[triangle->field_0].intensity;
+            int v34 = intensities[triangle->field_4] - intensities[triangle->field_0];
             // TODO: Probably wrong.
             int v35 = v34 / 32;
-            int v36 = (verticies[triangle->field_0].intensity - v32) / 13;
+            int v36 = (intensities[triangle->field_0] - v32) / 13;
             int* v37 = &(intensity_map[v33]);
             if (v35 != 0) {
                 if (v36 != 0) {
@@ -1748,12 +2341,12 @@ void floor_draw(int fid, int x, int y, Rect* rect)
 
         for (int i = 0; i < 5; i++) {
             UpsideDownTriangle* triangle = &(upside_down_triangles[i]);
-            int v50 = verticies[triangle->field_0].intensity;
+            int v50 = intensities[triangle->field_0];
             int v51 = verticies[triangle->field_0].field_0;
-            int v52 = verticies[triangle->field_8].intensity - v50;
+            int v52 = intensities[triangle->field_8] - v50;
             // TODO: Probably wrong.
             int v53 = v52 / 32;
-            int v54 = (verticies[triangle->field_4].intensity - v50) / 13;
+            int v54 = (intensities[triangle->field_4] - v50) / 13;
             int* v55 = &(intensity_map[v51]);
             if (v53 != 0) {
                 if (v54 != 0) {
@@ -1800,6 +2393,35 @@ void floor_draw(int fid, int x, int y, Rect* rect)
             }
         }
 
+        if (cacheable) {
+            unsigned char* data;
+            CacheEntry* lightCacheEntry;
+            floor_lock();
+            floor_light_cache_art = art;
+            floor_light_cache_fid = fid;
+            floor_light_cache_intensities = intensities;
+            bool locked = cache_lock(&floor_light_cache, cacheKey, (void**)&data, &lightCacheEntry);
+            floor_unlock();
+
+            if (locked) {
+                // NOTE: Lit pixels are copied where frame is not transparent
+                // since lighting can turn non-transparent color into 0.
+                mask_buf_to_buf(data + sizeof(FloorLightCacheHeader) + frameWidth * v78 + v79,
+                    v77,
+                    v76,
+                    frameWidth,
+                    art_frame_data(art, 0, 0) + frameWidth * v78 + v79,
+                    frameWidth,
+                    buf + buf_full * y + x,
+                    buf_full);
+
+                floor_lock();
+                cache_unlock(&floor_light_cache, lightCacheEntry);
+                floor_unlock();
+                goto out;
+            }
+        }
+
         unsigned char* v66 = buf + buf_full * y + x;
         unsigned char* v67 = art_frame_data(art, 0, 0) + frameWidth * v78 + v79;
         int* v68 = &(intensity_map[160 + 80 * v78]) + v79;
@@ -1824,7 +2446,75 @@ void floor_draw(int fid, int x, int y, Rect* rect)
 
 out:
 
+    floor_lock();
     art_ptr_unlock(cacheEntry);
+    floor_unlock();
+}
+
+// Hashes fid and vertex intensities into [floor_light_cache] key.
+static int floor_light_cache_key(int fid, const int* intensities)
+{
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ (unsigned int)fid) * 16777619u;
+    for (int index = 0; index < FLOOR_VERTEX_COUNT; index++) {
+        hash = (hash ^ (unsigned int)intensities[index]) * 16777619u;
+    }
+    return (int)hash;
+}
+
+static bool floor_light_cache_matches(unsigned char* data, int fid, const int* intensities)
+{
+    FloorLightCacheHeader* header = (FloorLightCacheHeader*)data;
+    if (header->fid != fid) {
+        return false;
+    }
+
+    for (int index = 0; index < FLOOR_VERTEX_COUNT; index++) {
+        if (header->intensities[index] != intensities[index]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int floor_light_cache_size(int key, int* sizePtr)
+{
+    Art* art = floor_light_cache_art;
+    *sizePtr = sizeof(FloorLightCacheHeader) + art_frame_width(art, 0, 0) * art_frame_length(art, 0, 0);
+    return 0;
+}
+
+// Lights entire tile frame using [intensity_map] prepared by [floor_draw].
+static int floor_light_cache_read(int key, int* sizePtr, unsigned char* data)
+{
+    Art* art = floor_light_cache_art;
+    int width = art_frame_width(art, 0, 0);
+    int height = art_frame_length(art, 0, 0);
+
+    FloorLightCacheHeader* header = (FloorLightCacheHeader*)data;
+    header->fid = floor_light_cache_fid;
+    for (int index = 0; index < FLOOR_VERTEX_COUNT; index++) {
+        header->intensities[index] = floor_light_cache_intensities[index];
+    }
+    header->width = width;
+    header->height = height;
+
+    unsigned char* src = art_frame_data(art, 0, 0);
+    unsigned char* dest = data + sizeof(*header);
+    int* intensity = &(intensity_map[160]);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            dest[x] = src[x] != 0 ? intensityColorTable[src[x]][intensity[x] >> 9] : 0;
+        }
+        src += width;
+        dest += width;
+        intensity += 80;
+    }
+
+    *sizePtr = sizeof(*header) + width * height;
+
+    return 0;
 }
 
 // 0x4A01CC
@@ -68,6 +68,8 @@ void tile_update_bounds_rect();
 int tile_inside_bound(Rect* rect);
 bool tile_point_inside_bound(int x, int y);
 void bounds_render(Rect* rect, int elevation);
+void tile_floor_layer_invalidate_all();
+void tile_floor_layer_invalidate_tile(int elevation, int tile);
 
 } // namespace fallout
 
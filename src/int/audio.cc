@@ -13,6 +13,12 @@
 
 namespace fallout {
 
+// Size of the decoded samples window kept for every compressed file.
+#define AUDIO_HISTORY_SIZE 0x10000
+
+// Size of chunks used to decode and discard data when seeking forward.
+#define AUDIO_SKIP_CHUNK_SIZE 0x4000
+
 typedef enum AudioFlags {
     AUDIO_FILE_IN_USE = 0x01,
     AUDIO_FILE_COMPRESSED = 0x02,
@@ -26,10 +32,17 @@ typedef struct Audio {
     int sampleRate;
     int channels;
     int position;
+
+    // Decoded samples are kept in [history] ring so that short backward seeks
+    // can be replayed without restarting [audioDecoder] from the beginning.
+    unsigned char* history;
+    int decodedPosition;
 } Audio;
 
 static bool defaultCompressionFunc(char* filePath);
 static unsigned int decodeRead(void* stream, void* buf, unsigned int size);
+static int audioDecode(Audio* audioFile, unsigned char* buffer, unsigned int size);
+static void audioSkip(int fileHandle, int size);
 
 // 0x4FEC00
 static AudioQueryCompressedFunc* queryCompressedFunc = defaultCompressionFunc;
@@ -57,6 +70,76 @@ static unsigned int decodeRead(void* stream, void* buffer, unsigned int size)
     return db_fread(buffer, 1, size, (DB_FILE*)stream);
 }
 
+// Decodes next portion of compressed file, replaying data from history window
+// first when [position] is behind [decodedPosition] as a result of seek.
+static int audioDecode(Audio* audioFile, unsigned char* buffer, unsigned int size)
+{
+    int bytesRead = 0;
+
+    while (bytesRead < (int)size && audioFile->position + bytesRead < audioFile->decodedPosition) {
+        int historyOffset = (audioFile->position + bytesRead) % AUDIO_HISTORY_SIZE;
+        int chunkSize = audioFile->decodedPosition - (audioFile->position + bytesRead);
+        if (chunkSize > AUDIO_HISTORY_SIZE - historyOffset) {
+            chunkSize = AUDIO_HISTORY_SIZE - historyOffset;
+        }
+        if (chunkSize > (int)size - bytesRead) {
+            chunkSize = (int)size - bytesRead;
+        }
+
+        memcpy(buffer + bytesRead, audioFile->history + historyOffset, chunkSize);
+        bytesRead += chunkSize;
+    }
+
+    if (bytesRead < (int)size) {
+        int decoded = AudioDecoder_Read(audioFile->audioDecoder, buffer + bytesRead, size - bytesRead);
+
+        // Only the tail of decoded data fits into history window.
+        int skipped = decoded > AUDIO_HISTORY_SIZE ? decoded - AUDIO_HISTORY_SIZE : 0;
+        if (audioFile->history == NULL) {
+            skipped = decoded;
+        }
+
+        unsigned char* src = buffer + bytesRead + skipped;
+        int historyPosition = audioFile->decodedPosition + skipped;
+        int remaining = decoded - skipped;
+        while (remaining > 0) {
+            int historyOffset = historyPosition % AUDIO_HISTORY_SIZE;
+            int chunkSize = AUDIO_HISTORY_SIZE - historyOffset;
+            if (chunkSize > remaining) {
+                chunkSize = remaining;
+            }
+
+            memcpy(audioFile->history + historyOffset, src, chunkSize);
+            src += chunkSize;
+            historyPosition += chunkSize;
+            remaining -= chunkSize;
+        }
+
+        audioFile->decodedPosition += decoded;
+        bytesRead += decoded;
+    }
+
+    return bytesRead;
+}
+
+// Decodes and discards [size] bytes of compressed file.
+static void audioSkip(int fileHandle, int size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    unsigned char* buf = (unsigned char*)mymalloc(AUDIO_SKIP_CHUNK_SIZE, __FILE__, __LINE__);
+    while (size > 0) {
+        int chunkSize = size < AUDIO_SKIP_CHUNK_SIZE ? size : AUDIO_SKIP_CHUNK_SIZE;
+        if (audioRead(fileHandle, buf, chunkSize) <= 0) {
+            break;
+        }
+        size -= chunkSize;
+    }
+    myfree(buf, __FILE__, __LINE__);
+}
+
 // 0x41992C
 int audioOpen(const char* fname, int flags)
 {
@@ -121,11 +204,14 @@ int audioOpen(const char* fname, int flags)
         audioFile->flags |= AUDIO_FILE_COMPRESSED;
         audioFile->audioDecoder = Create_AudioDecoder(decodeRead, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
         audioFile->fileSize *= 2;
+        audioFile->history = (unsigned char*)mymalloc(AUDIO_HISTORY_SIZE, __FILE__, __LINE__);
     } else {
+        audioFile->history = NULL;
         audioFile->fileSize = db_filelength(stream);
     }
 
     audioFile->position = 0;
+    audioFile->decodedPosition = 0;
 
     return index + 1;
 }
@@ -138,6 +224,10 @@ int audioCloseFile(int fileHandle)
 
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
         AudioDecoder_Close(audioFile->audioDecoder);
+
+        if (audioFile->history != NULL) {
+            myfree(audioFile->history, __FILE__, __LINE__);
+        }
     }
 
     memset(audioFile, 0, sizeof(Audio));
@@ -152,7 +242,7 @@ int audioRead(int fileHandle, void* buffer, unsigned int size)
 
     int bytesRead;
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
-        bytesRead = AudioDecoder_Read(audioFile->audioDecoder, buffer, size);
+        bytesRead = audioDecode(audioFile, (unsigned char*)buffer, size);
     } else {
         bytesRead = db_fread(buffer, 1, size, audioFile->stream);
     }
@@ -166,8 +256,6 @@ int audioRead(int fileHandle, void* buffer, unsigned int size)
 long audioSeek(int fileHandle, long offset, int origin)
 {
     int pos;
-    unsigned char* buf;
-    int v10;
 
     Audio* audioFile = &(audio[fileHandle - 1]);
 
@@ -186,41 +274,28 @@ long audioSeek(int fileHandle, long offset, int origin)
     }
 
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
-        if (pos < audioFile->position) {
+        if (pos < 0) {
+            pos = 0;
+        }
+
+        if (audioFile->history == NULL || pos < audioFile->decodedPosition - AUDIO_HISTORY_SIZE) {
+            // Target is no longer in history window, the only way to get
+            // there is to decode everything from the beginning.
             AudioDecoder_Close(audioFile->audioDecoder);
             db_fseek(audioFile->stream, 0, SEEK_SET);
             audioFile->audioDecoder = Create_AudioDecoder(decodeRead, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
-            audioFile->position = 0;
             audioFile->fileSize *= 2;
-
-            if (pos != 0) {
-                buf = (unsigned char*)mymalloc(4096, __FILE__, __LINE__); // "..\int\audio.c", 361
-                while (pos > 4096) {
-                    pos -= 4096;
-                    audioRead(fileHandle, buf, 4096);
-                }
-
-                if (pos != 0) {
-                    audioRead(fileHandle, buf, pos);
-                }
-
-                myfree(buf, __FILE__, __LINE__); // // "..\int\audio.c", 367
-            }
+            audioFile->position = 0;
+            audioFile->decodedPosition = 0;
+        } else if (pos < audioFile->decodedPosition) {
+            // Replay from history window.
+            audioFile->position = pos;
         } else {
-            buf = (unsigned char*)mymalloc(1024, __FILE__, __LINE__); // "..\int\audio.c", 321
-            v10 = audioFile->position - pos;
-            while (v10 > 1024) {
-                v10 -= 1024;
-                audioRead(fileHandle, buf, 1024);
-            }
-
-            if (v10 != 0) {
-                audioRead(fileHandle, buf, v10);
-            }
-
-            // TODO: Probably leaks memory.
+            audioFile->position = audioFile->decodedPosition;
         }
 
+        audioSkip(fileHandle, pos - audioFile->position);
+
         return audioFile->position;
     } else {
         return db_fseek(audioFile->stream, offset, origin);
@@ -13,6 +13,12 @@
 
 namespace fallout {
 
+// Size of the decoded samples window kept for every compressed file.
+#define AUDIO_HISTORY_SIZE 0x10000
+
+// Size of chunks used to decode and discard data when seeking forward.
+#define AUDIO_SKIP_CHUNK_SIZE 0x4000
+
 typedef enum AudioFileFlags {
     AUDIO_FILE_IN_USE = 0x01,
     AUDIO_FILE_COMPRESSED = 0x02,
@@ -26,10 +32,17 @@ typedef struct AudioFile {
     int sampleRate;
     int channels;
     int position;
+
+    // Decoded samples are kept in [history] ring so that short backward seeks
+    // can be replayed without restarting [audioDecoder] from the beginning.
+    unsigned char* history;
+    int decodedPosition;
 } AudioFile;
 
 static bool defaultCompressionFunc(char* filePath);
 static unsigned int decodeRead(void* stream, void* buffer, unsigned int size);
+static int audiofDecode(AudioFile* audioFile, unsigned char* buffer, unsigned int size);
+static void audiofSkip(int fileHandle, int size);
 
 // 0x4FEC04
 static AudioFileQueryCompressedFunc* queryCompressedFunc = defaultCompressionFunc;
@@ -57,6 +70,76 @@ static unsigned int decodeRead(void* stream, void* buffer, unsigned int size)
     return fread(buffer, 1, size, (FILE*)stream);
 }
 
+// Decodes next portion of compressed file, replaying data from history window
+// first when [position] is behind [decodedPosition] as a result of seek.
+static int audiofDecode(AudioFile* audioFile, unsigned char* buffer, unsigned int size)
+{
+    int bytesRead = 0;
+
+    while (bytesRead < (int)size && audioFile->position + bytesRead < audioFile->decodedPosition) {
+        int historyOffset = (audioFile->position + bytesRead) % AUDIO_HISTORY_SIZE;
+        int chunkSize = audioFile->decodedPosition - (audioFile->position + bytesRead);
+        if (chunkSize > AUDIO_HISTORY_SIZE - historyOffset) {
+            chunkSize = AUDIO_HISTORY_SIZE - historyOffset;
+        }
+        if (chunkSize > (int)size - bytesRead) {
+            chunkSize = (int)size - bytesRead;
+        }
+
+        memcpy(buffer + bytesRead, audioFile->history + historyOffset, chunkSize);
+        bytesRead += chunkSize;
+    }
+
+    if (bytesRead < (int)size) {
+        int decoded = AudioDecoder_Read(audioFile->audioDecoder, buffer + bytesRead, size - bytesRead);
+
+        // Only the tail of decoded data fits into history window.
+        int skipped = decoded > AUDIO_HISTORY_SIZE ? decoded - AUDIO_HISTORY_SIZE : 0;
+        if (audioFile->history == NULL) {
+            skipped = decoded;
+        }
+
+        unsigned char* src = buffer + bytesRead + skipped;
+        int historyPosition = audioFile->decodedPosition + skipped;
+        int remaining = decoded - skipped;
+        while (remaining > 0) {
+            int historyOffset = historyPosition % AUDIO_HISTORY_SIZE;
+            int chunkSize = AUDIO_HISTORY_SIZE - historyOffset;
+            if (chunkSize > remaining) {
+                chunkSize = remaining;
+            }
+
+            memcpy(audioFile->history + historyOffset, src, chunkSize);
+            src += chunkSize;
+            historyPosition += chunkSize;
+            remaining -= chunkSize;
+        }
+
+        audioFile->decodedPosition += decoded;
+        bytesRead += decoded;
+    }
+
+    return bytesRead;
+}
+
+// Decodes and discards [size] bytes of compressed file.
+static void audiofSkip(int fileHandle, int size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    unsigned char* buf = (unsigned char*)mymalloc(AUDIO_SKIP_CHUNK_SIZE, __FILE__, __LINE__);
+    while (size > 0) {
+        int chunkSize = size < AUDIO_SKIP_CHUNK_SIZE ? size : AUDIO_SKIP_CHUNK_SIZE;
+        if (audiofRead(fileHandle, buf, chunkSize) <= 0) {
+            break;
+        }
+        size -= chunkSize;
+    }
+    myfree(buf, __FILE__, __LINE__);
+}
+
 // 0x419ECC
 int audiofOpen(const char* fname, int flags)
 {
@@ -120,11 +203,14 @@ int audiofOpen(const char* fname, int flags)
         audioFile->flags |= AUDIO_FILE_COMPRESSED;
         audioFile->audioDecoder = Create_AudioDecoder(decodeRead, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
         audioFile->fileSize *= 2;
+        audioFile->history = (unsigned char*)mymalloc(AUDIO_HISTORY_SIZE, __FILE__, __LINE__);
     } else {
+        audioFile->history = NULL;
         audioFile->fileSize = getFileSize(stream);
     }
 
     audioFile->position = 0;
+    audioFile->decodedPosition = 0;
 
     return index + 1;
 }
@@ -137,6 +223,10 @@ int audiofCloseFile(int fileHandle)
 
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
         AudioDecoder_Close(audioFile->audioDecoder);
+
+        if (audioFile->history != NULL) {
+            myfree(audioFile->history, __FILE__, __LINE__);
+        }
     }
 
     // Reset audio file (which also resets it's use flag).
@@ -153,7 +243,7 @@ int audiofRead(int fileHandle, void* buffer, unsigned int size)
 
     int bytesRead;
     if ((ptr->flags & AUDIO_FILE_COMPRESSED) != 0) {
-        bytesRead = AudioDecoder_Read(ptr->audioDecoder, buffer, size);
+        bytesRead = audiofDecode(ptr, (unsigned char*)buffer, size);
     } else {
         bytesRead = fread(buffer, 1, size, ptr->stream);
     }
@@ -166,8 +256,6 @@ int audiofRead(int fileHandle, void* buffer, unsigned int size)
 // 0x41A1B4
 long audiofSeek(int fileHandle, long offset, int origin)
 {
-    void* buf;
-    int remaining;
     int a4;
 
     AudioFile* audioFile = &(audiof[fileHandle - 1]);
@@ -187,36 +275,28 @@ long audiofSeek(int fileHandle, long offset, int origin)
     }
 
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
-        if (a4 <= audioFile->position) {
+        if (a4 < 0) {
+            a4 = 0;
+        }
+
+        if (audioFile->history == NULL || a4 < audioFile->decodedPosition - AUDIO_HISTORY_SIZE) {
+            // Target is no longer in history window, the only way to get
+            // there is to decode everything from the beginning.
             AudioDecoder_Close(audioFile->audioDecoder);
             fseek(audioFile->stream, 0, SEEK_SET);
             audioFile->audioDecoder = Create_AudioDecoder(decodeRead, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
             audioFile->fileSize *= 2;
             audioFile->position = 0;
-
-            if (a4) {
-                buf = mymalloc(4096, __FILE__, __LINE__); // "..\int\audiof.c", 363
-                while (a4 > 4096) {
-                    audiofRead(fileHandle, buf, 4096);
-                    a4 -= 4096;
-                }
-                if (a4 != 0) {
-                    audiofRead(fileHandle, buf, a4);
-                }
-                myfree(buf, __FILE__, __LINE__); // "..\int\audiof.c", 369
-            }
+            audioFile->decodedPosition = 0;
+        } else if (a4 < audioFile->decodedPosition) {
+            // Replay from history window.
+            audioFile->position = a4;
         } else {
-            buf = mymalloc(0x400, __FILE__, __LINE__); // "..\int\audiof.c", 315
-            remaining = audioFile->position - a4;
-            while (remaining > 1024) {
-                audiofRead(fileHandle, buf, 1024);
-                remaining -= 1024;
-            }
-            if (remaining != 0) {
-                audiofRead(fileHandle, buf, remaining);
-            }
-            // TODO: Obiously leaks memory.
+            audioFile->position = audioFile->decodedPosition;
         }
+
+        audiofSkip(fileHandle, a4 - audioFile->position);
+
         return audioFile->position;
     }
 
@@ -46,7 +46,10 @@ static opcode_t popShortStack(unsigned char* a1, int* a2);
 static void detachProgram(Program* program);
 static void purgeProgram(Program* program);
 static opcode_t getOp(Program* program);
+static void decodeInstruction(Program* program, int instructionPointer, opcode_t opcode, OpcodeHandler* handler);
 static void checkProgramStrings(Program* program);
+static unsigned int interpretHashString(const char* string);
+static bool interpretGrowStringIndex(Program* program);
 static void op_noop(Program* program);
 static void op_const(Program* program);
 static void op_push_base(Program* program);
@@ -151,6 +154,10 @@ static int cpuBurstSize = 10;
 // 0x59E230
 static OpcodeHandler* opTable[OPCODE_MAX_COUNT];
 
+// Incremented every time [opTable] changes, invalidates instructions decoded
+// by programs.
+static unsigned int opTableGeneration = 0;
+
 // 0x59E788
 static unsigned int suspendTime;
 
@@ -411,16 +418,25 @@ void interpretFreeProgram(Program* program)
         myfree(program->dynamicStrings, __FILE__, __LINE__); // "..\int\INTRPRET.C", 371
     }
 
+    if (program->dynamicStringsIndex != NULL) {
+        myfree(program->dynamicStringsIndex, __FILE__, __LINE__);
+    }
+
     if (program->data != NULL) {
         myfree(program->data, __FILE__, __LINE__); // "..\int\INTRPRET.C", 372
     }
 
+    if (program->instructionIndex != NULL) {
+        myfree(program->instructionIndex, __FILE__, __LINE__);
+    }
+
     if (program->name != NULL) {
         myfree(program->name, __FILE__, __LINE__); // "..\int\INTRPRET.C", 373
     }
 
     delete program->stackValues;
     delete program->returnStackValues;
+    delete program->instructions;
 
     myfree(program, __FILE__, __LINE__); // "..\int\INTRPRET.C", 377
 }
@@ -451,6 +467,7 @@ Program* allocateProgram(const char* path)
     program->child = NULL;
     program->parent = NULL;
     program->field_78 = -1;
+    program->sid = -1;
     program->exited = false;
     program->basePointer = -1;
     program->framePointer = -1;
@@ -458,9 +475,21 @@ Program* allocateProgram(const char* path)
     program->procedures = data + 42;
     program->identifiers = sizeof(Procedure) * fetchLong(program->procedures, 0) + program->procedures + 4;
     program->staticStrings = program->identifiers + fetchLong(program->identifiers, 0) + 4;
+    program->dataSize = fileSize;
+
+    // Instructions are decoded on their first execution, code and data are
+    // interleaved and jump targets are only known at runtime. It's fine to go
+    // without decoding if allocation fails.
+    size_t instructionIndexSize = sizeof(*program->instructionIndex) * (fileSize / 2);
+    program->instructionIndex = (unsigned short*)mymalloc(instructionIndexSize, __FILE__, __LINE__);
+    if (program->instructionIndex != NULL) {
+        memset(program->instructionIndex, 0, instructionIndexSize);
+    }
+    program->instructionsGeneration = opTableGeneration;
 
     program->stackValues = new ProgramStack();
     program->returnStackValues = new ProgramStack();
+    program->instructions = new ProgramInstructionList();
 
     return program;
 }
@@ -477,6 +506,43 @@ static opcode_t getOp(Program* program)
     return fetchWord(program->data, instructionPointer);
 }
 
+// Remembers instruction at [instructionPointer] which was just fetched and
+// validated the slow way, so [interpret] can run it straight from the decoded
+// record next time. Push opcodes have their operand read in advance.
+static void decodeInstruction(Program* program, int instructionPointer, opcode_t opcode, OpcodeHandler* handler)
+{
+    if (program->instructionIndex == NULL) {
+        return;
+    }
+
+    if ((instructionPointer & 1) != 0 || instructionPointer < 0 || instructionPointer + 2 > program->dataSize) {
+        return;
+    }
+
+    // Index is 16-bit, the rest of instructions keep using slow path.
+    if (program->instructions->size() >= USHRT_MAX) {
+        return;
+    }
+
+    ProgramInstruction instruction;
+    instruction.handler = handler;
+    instruction.nextInstructionPointer = instructionPointer + 2;
+    instruction.operand = 0;
+    instruction.opcode = opcode;
+
+    if (handler == op_const) {
+        if (instructionPointer + 6 > program->dataSize) {
+            return;
+        }
+
+        instruction.operand = fetchLong(program->data, instructionPointer + 2);
+        instruction.nextInstructionPointer = instructionPointer + 6;
+    }
+
+    program->instructions->push_back(instruction);
+    program->instructionIndex[instructionPointer / 2] = (unsigned short)program->instructions->size();
+}
+
 // 0x45BC2C
 char* interpretGetString(Program* program, opcode_t opcode, int offset)
 {
@@ -518,45 +584,72 @@ int interpretAddString(Program* program, char* string)
         v27++;
     }
 
+    program->dynamicStringsAddCount++;
+
+    unsigned int hash = interpretHashString(string);
+
     if (program->dynamicStrings != NULL) {
-        // TODO: Needs testing, lots of pointer stuff.
-        unsigned char* heap = program->dynamicStrings + 4;
-        while (*(unsigned short*)heap != 0x8000) {
-            short v2 = *(short*)heap;
-            if (v2 >= 0) {
+        if (program->dynamicStringsIndex != NULL) {
+            int mask = program->dynamicStringsIndexCapacity - 1;
+            int slot = hash & mask;
+            while (program->dynamicStringsIndex[slot].offset != -1) {
+                program->dynamicStringsProbeCount++;
+
+                ProgramStringIndexEntry* entry = &(program->dynamicStringsIndex[slot]);
+                if (entry->hash == hash) {
+                    unsigned char* heap = program->dynamicStrings + entry->offset;
+                    if (*(short*)heap == v27 && strcmp(string, (char*)(heap + 4)) == 0) {
+                        return entry->offset;
+                    }
+                }
+
+                slot = (slot + 1) & mask;
+            }
+        } else {
+            // Strings are never freed, so heap consists of used blocks only.
+            unsigned char* heap = program->dynamicStrings + 4;
+            while (*(unsigned short*)heap != 0x8000) {
+                short v2 = *(short*)heap;
                 if (v2 == v27) {
                     if (strcmp(string, (char*)(heap + 4)) == 0) {
                         return (heap + 4) - (program->dynamicStrings + 4);
                     }
                 }
-            } else {
-                v2 = -v2;
-                if (v2 > v27) {
-                    if (v2 - v27 <= 4) {
-                        *(short*)heap = v2;
-                    } else {
-                        *(short*)(heap + v27 + 6) = 0;
-                        *(short*)(heap + v27 + 4) = -(v2 - v27 - 4);
-                        *(short*)(heap) = v27;
-                    }
-
-                    *(short*)(heap + 2) = 0;
-                    strcpy((char*)(heap + 4), string);
-
-                    *(heap + v27 + 3) = '\0';
-                    return (heap + 4) - (program->dynamicStrings + 4);
-                }
+                heap += v2 + 4;
             }
-            heap += v2 + 4;
         }
     } else {
         program->dynamicStrings = (unsigned char*)mymalloc(8, __FILE__, __LINE__); // "..\int\INTRPRET.C", 459
         *(int*)(program->dynamicStrings) = 0;
         *(unsigned short*)(program->dynamicStrings + 4) = 0x8000;
         *(short*)(program->dynamicStrings + 6) = 1;
+        program->dynamicStringsCapacity = 8;
+    }
+
+    // Keep load factor under 1/2. Index is optional, without it strings are
+    // looked up with linear scan above.
+    if ((program->dynamicStringsIndexLength + 1) * 2 > program->dynamicStringsIndexCapacity) {
+        if (!interpretGrowStringIndex(program)) {
+            if (program->dynamicStringsIndex != NULL) {
+                myfree(program->dynamicStringsIndex, __FILE__, __LINE__);
+                program->dynamicStringsIndex = NULL;
+            }
+            program->dynamicStringsIndexCapacity = 0;
+            program->dynamicStringsIndexLength = 0;
+        }
     }
 
-    program->dynamicStrings = (unsigned char*)myrealloc(program->dynamicStrings, *(int*)(program->dynamicStrings) + 8 + 4 + v27, __FILE__, __LINE__); // "..\int\INTRPRET.C", 466
+    // Grow geometrically to avoid copying whole heap on every new string.
+    int size = *(int*)(program->dynamicStrings) + 8 + 4 + v27;
+    if (size > program->dynamicStringsCapacity) {
+        int capacity = program->dynamicStringsCapacity * 2;
+        if (capacity < size) {
+            capacity = size;
+        }
+
+        program->dynamicStrings = (unsigned char*)myrealloc(program->dynamicStrings, capacity, __FILE__, __LINE__); // "..\int\INTRPRET.C", 466
+        program->dynamicStringsCapacity = capacity;
+    }
 
     v20 = program->dynamicStrings + *(int*)(program->dynamicStrings) + 4;
     if ((*(short*)v20 & 0xFFFF) != 0x8000) {
@@ -575,7 +668,79 @@ int interpretAddString(Program* program, char* string)
     *(unsigned short*)(v23 + 4) = 0x8000;
     *(short*)(v23 + 6) = 1;
 
-    return v20 + 4 - (program->dynamicStrings + 4);
+    int offset = v20 + 4 - (program->dynamicStrings + 4);
+
+    if (program->dynamicStringsIndex != NULL) {
+        int mask = program->dynamicStringsIndexCapacity - 1;
+        int slot = hash & mask;
+        while (program->dynamicStringsIndex[slot].offset != -1) {
+            slot = (slot + 1) & mask;
+        }
+
+        program->dynamicStringsIndex[slot].offset = offset;
+        program->dynamicStringsIndex[slot].hash = hash;
+        program->dynamicStringsIndexLength++;
+    }
+
+    return offset;
+}
+
+// FNV-1a.
+static unsigned int interpretHashString(const char* string)
+{
+    unsigned int hash = 2166136261U;
+    while (*string != '\0') {
+        hash ^= (unsigned char)*string++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+// Doubles capacity of dynamic strings index and rehashes all strings in
+// dynamic strings heap.
+static bool interpretGrowStringIndex(Program* program)
+{
+    int capacity = program->dynamicStringsIndexCapacity != 0 ? program->dynamicStringsIndexCapacity * 2 : 64;
+
+    ProgramStringIndexEntry* index = (ProgramStringIndexEntry*)mymalloc(sizeof(*index) * capacity, __FILE__, __LINE__);
+    if (index == NULL) {
+        return false;
+    }
+
+    for (int slot = 0; slot < capacity; slot++) {
+        index[slot].offset = -1;
+    }
+
+    int mask = capacity - 1;
+    int length = 0;
+
+    unsigned char* heap = program->dynamicStrings + 4;
+    while (*(unsigned short*)heap != 0x8000) {
+        short v2 = *(short*)heap;
+        char* string = (char*)(heap + 4);
+        unsigned int hash = interpretHashString(string);
+
+        int slot = hash & mask;
+        while (index[slot].offset != -1) {
+            slot = (slot + 1) & mask;
+        }
+
+        index[slot].offset = (heap + 4) - (program->dynamicStrings + 4);
+        index[slot].hash = hash;
+        length++;
+
+        heap += v2 + 4;
+    }
+
+    if (program->dynamicStringsIndex != NULL) {
+        myfree(program->dynamicStringsIndex, __FILE__, __LINE__);
+    }
+
+    program->dynamicStringsIndex = index;
+    program->dynamicStringsIndexCapacity = capacity;
+    program->dynamicStringsIndexLength = length;
+
+    return true;
 }
 
 // 0x45BDB4
@@ -2560,6 +2725,12 @@ void interpret(Program* program, int a2)
 
     currentProgram = program;
 
+    if (program->instructionIndex != NULL && program->instructionsGeneration != opTableGeneration) {
+        memset(program->instructionIndex, 0, sizeof(*program->instructionIndex) * (program->dataSize / 2));
+        program->instructions->clear();
+        program->instructionsGeneration = opTableGeneration;
+    }
+
     if (setjmp(program->env)) {
         currentProgram = oldCurrentProgram;
         program->flags |= PROGRAM_FLAG_EXITED | PROGRAM_FLAG_0x04;
@@ -2594,6 +2765,32 @@ void interpret(Program* program, int a2)
             program->flags &= ~PROGRAM_IS_WAITING;
         }
 
+        int instructionPointer = program->instructionPointer;
+
+        // Decoded instructions skip fetching and validating opcode. The high
+        // half of `flags` is not updated for them, the only handler reading
+        // it is `op_const` which is executed inline.
+        if ((instructionPointer & 1) == 0
+            && (unsigned int)instructionPointer < (unsigned int)program->dataSize
+            && program->instructionIndex != NULL) {
+            unsigned short index = program->instructionIndex[instructionPointer / 2];
+            if (index != 0) {
+                const ProgramInstruction& instruction = (*program->instructions)[index - 1];
+                program->instructionPointer = instruction.nextInstructionPointer;
+
+                if (instruction.handler == op_const) {
+                    ProgramValue value;
+                    value.opcode = instruction.opcode;
+                    value.integerValue = instruction.operand;
+                    programStackPushValue(program, value);
+                } else {
+                    instruction.handler(program);
+                }
+
+                continue;
+            }
+        }
+
         // NOTE: Uninline.
         opcode_t opcode = getOp(program);
 
@@ -2613,6 +2810,8 @@ void interpret(Program* program, int a2)
             interpretError(err);
         }
 
+        decodeInstruction(program, instructionPointer, opcode, handler);
+
         handler(program);
     }
 
@@ -3046,6 +3245,7 @@ void interpretAddFunc(int opcode, OpcodeHandler* handler)
     }
 
     opTable[index] = handler;
+    opTableGeneration++;
 }
 
 // 0x4620D4
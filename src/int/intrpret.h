@@ -148,8 +148,32 @@ typedef struct ProgramValue {
 
 typedef std::vector<ProgramValue> ProgramStack;
 
+typedef struct ProgramStringIndexEntry {
+    // Offset of string in `Program::dynamicStrings` as returned from
+    // `interpretAddString`, -1 if slot is empty.
+    int offset;
+    unsigned int hash;
+} ProgramStringIndexEntry;
+
 typedef struct Program Program;
 typedef int(InterpretCheckWaitFunc)(Program* program);
+typedef void(OpcodeHandler)(Program* program);
+
+// Instruction decoded on its first execution.
+typedef struct ProgramInstruction {
+    OpcodeHandler* handler;
+
+    // Position of the instruction following this one in `Program::data`.
+    int nextInstructionPointer;
+
+    // Inline operand of push opcodes (integer, float bits or string offset),
+    // not used by other opcodes.
+    int operand;
+
+    opcode_t opcode;
+} ProgramInstruction;
+
+typedef std::vector<ProgramInstruction> ProgramInstructionList;
 
 // It's size in original code is 144 (0x8C) bytes due to the different
 // size of `jmp_buf`.
@@ -175,12 +199,47 @@ typedef struct Program {
     bool exited;
     ProgramStack* stackValues;
     ProgramStack* returnStackValues;
+
+    // Size of `data` in bytes.
+    int dataSize;
+
+    // One-based index into `instructions` for every 2-byte aligned position
+    // in `data`, 0 if instruction at that position was not decoded yet.
+    unsigned short* instructionIndex;
+
+    // Instructions decoded so far, in order of their first execution.
+    ProgramInstructionList* instructions;
+
+    // Value of opcode table generation `instructions` were decoded against.
+    unsigned int instructionsGeneration;
+
+    // SID of the game script this program was loaded for, -1 if none.
+    int sid;
+
+    // Allocated size of `dynamicStrings` in bytes.
+    int dynamicStringsCapacity;
+
+    // Open-addressing hash table (linear probing) of strings in
+    // `dynamicStrings`.
+    ProgramStringIndexEntry* dynamicStringsIndex;
+
+    // The capacity of `dynamicStringsIndex`, always a power of two.
+    int dynamicStringsIndexCapacity;
+
+    // The number of used slots in `dynamicStringsIndex`.
+    int dynamicStringsIndexLength;
+
+    // Number of `interpretAddString` calls.
+    unsigned int dynamicStringsAddCount;
+
+    // Number of `dynamicStringsIndex` slots examined by `interpretAddString`
+    // calls.
+    unsigned int dynamicStringsProbeCount;
 } Program;
 
 typedef char*(InterpretMangleFunc)(char* fileName);
 typedef int(InterpretOutputFunc)(char* string);
 typedef unsigned int(InterpretTimerFunc)();
-typedef void(OpcodeHandler)(Program* program);
 
 void interpretSetTimeFunc(InterpretTimerFunc* timerFunc, int timerTick);
 char* interpretMangleName(char* fileName);
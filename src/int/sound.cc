@@ -430,6 +430,13 @@ static void refreshSoundBuffers(Sound* sound)
     return;
 }
 
+// Sets maximum number of sounds playing at once, must be called before
+// [soundInit].
+void soundSetMaxVoices(int count)
+{
+    audioEngineSetMaxSoundBuffers(count);
+}
+
 // 0x49A1E4
 int soundInit(int a1, int num_buffers, int a3, int data_size, int sample_rate)
 {
@@ -697,7 +704,15 @@ int soundSetData(Sound* sound, unsigned char* buf, int size)
     }
 
     if (sound->soundBuffer == -1) {
-        sound->soundBuffer = audioEngineCreateSoundBuffer(size, sound->bitsPerSample, sound->channels, sound->rate);
+        // Music and speech stream, they must not be cut off by effects.
+        int priority = AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_NORMAL;
+        if ((sound->type & SOUND_TYPE_STREAMING) != 0) {
+            priority = AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_HIGH;
+        } else if ((sound->type & SOUND_TYPE_FIRE_AND_FORGET) != 0) {
+            priority = AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_LOW;
+        }
+
+        sound->soundBuffer = audioEngineCreateSoundBuffer(size, sound->bitsPerSample, sound->channels, sound->rate, priority);
         if (sound->soundBuffer == -1) {
             soundErrorno = SOUND_UNKNOWN_ERROR;
             return soundErrorno;
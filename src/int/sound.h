@@ -125,6 +125,7 @@ typedef struct Sound {
 
 void soundRegisterAlloc(SoundMallocFunc* mallocProc, SoundReallocFunc* reallocProc, SoundFreeFunc* freeProc);
 const char* soundError(int err);
+void soundSetMaxVoices(int count);
 int soundInit(int a1, int a2, int a3, int a4, int rate);
 void soundClose();
 Sound* soundAllocate(int a1, int a2);
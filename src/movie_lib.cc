@@ -1139,7 +1139,7 @@ static int _MVE_sndConfigure(int a1, int a2, int a3, int a4, int a5, int a6)
     dword_6B3AE4 = 0;
     dword_6B3660 = 0;
 
-    gMveSoundBuffer = audioEngineCreateSoundBuffer(gMveBufferBytes, a5 < 1 ? 8 : 16, 2 - (a3 < 1), a4);
+    gMveSoundBuffer = audioEngineCreateSoundBuffer(gMveBufferBytes, a5 < 1 ? 8 : 16, 2 - (a3 < 1), a4, AUDIO_ENGINE_SOUND_BUFFER_PRIORITY_HIGH);
     if (gMveSoundBuffer == -1) {
         return 0;
     }
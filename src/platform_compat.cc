@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #else
 #include <dirent.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -356,4 +357,56 @@ long getFileSize(FILE* stream)
     return filesize;
 }
 
+// Maps entire file opened as `stream` into memory for reading. Returns `NULL`
+// if file cannot be mapped, callers are expected to fall back to stdio.
+unsigned char* compat_map_file(FILE* stream, size_t* sizePtr)
+{
+    long size = getFileSize(stream);
+    if (size <= 0) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(stream));
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    // The view keeps mapping alive, so there is no need to keep its handle.
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (ptr == NULL) {
+        return NULL;
+    }
+#else
+    void* ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(stream), 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+#endif
+
+    *sizePtr = size;
+
+    return (unsigned char*)ptr;
+}
+
+void compat_unmap_file(unsigned char* ptr, size_t size)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(ptr);
+#else
+    munmap(ptr, size);
+#endif
+}
+
 } // namespace fallout
@@ -41,6 +41,8 @@ void compat_windows_path_to_native(char* path);
 void compat_resolve_path(char* path);
 char* compat_strdup(const char* string);
 long getFileSize(FILE* stream);
+unsigned char* compat_map_file(FILE* stream, size_t* sizePtr);
+void compat_unmap_file(unsigned char* ptr, size_t size);
 
 } // namespace fallout
 
@@ -23,6 +23,10 @@ namespace fallout {
 #define DB_DATABASE_FILE_LIST_CAPACITY 32
 #define DB_HASH_TABLE_SIZE 4095
 
+// Specifies that DB_FILE buffer points into memory mapped datafile and must
+// not be freed.
+#define DB_FILE_MAPPED 0x100
+
 #if defined(_WIN32)
 #define PATH_SEP '\\'
 #else
@@ -44,6 +48,18 @@ typedef struct DB_FILE {
     unsigned char* field_20;
 } DB_FILE;
 
+// An entry in datafile path index (see `db_init_path_index`).
+typedef struct db_path_index_entry {
+    // Hash of full normalized path, see `db_hash_path`.
+    unsigned int hash;
+
+    // Index into `DB_DATABASE.root`, or -1 if this slot is empty.
+    int dir_index;
+
+    // Index into `DB_DATABASE.entries[dir_index]`.
+    int entry_index;
+} db_path_index_entry;
+
 typedef struct DB_DATABASE {
     char* datafile;
     FILE* stream;
@@ -55,6 +71,16 @@ typedef struct DB_DATABASE {
     int files_length;
     DB_FILE files[DB_DATABASE_FILE_LIST_CAPACITY];
     unsigned char* hash_table;
+
+    // Read-only view of the entire datafile, or `NULL` when datafile cannot
+    // be mapped (in this case stored entries are read via `stream`).
+    unsigned char* mapping;
+    size_t mapping_size;
+
+    // Open-addressing index of all datafile entries by full path. The number
+    // of slots is always a power of two.
+    db_path_index_entry* path_index;
+    unsigned int path_index_mask;
 } DB_DATABASE;
 
 typedef struct DB_FIND_DATA {
@@ -103,6 +129,11 @@ static char* db_default_strdup(const char* string);
 static void db_default_free(void* ptr);
 static void db_preload_buffer(DB_FILE* stream);
 static int fread_short(FILE* stream, unsigned short* s);
+static bool db_is_mapped_entry(DB_DATABASE* database, dir_entry* de);
+static void db_unmap_database(DB_DATABASE* database);
+static int db_init_path_index(DB_DATABASE* database);
+static void db_exit_path_index(DB_DATABASE* database);
+static unsigned int db_hash_path(const char* dir, const char* name);
 
 static inline bool fileFindIsDirectory(DB_FIND_DATA* find_data);
 static inline char* fileFindGetName(DB_FIND_DATA* find_data);
@@ -353,6 +384,7 @@ int db_read_to_buf(const char* filename, unsigned char* buf)
     dir_entry de;
     unsigned char* end;
     unsigned short v4;
+    unsigned char* src;
 
     if (current_database == NULL) {
         return -1;
@@ -452,7 +484,32 @@ int db_read_to_buf(const char* filename, unsigned char* buf)
         lzss_decode_to_buf(current_database->stream, buf, de.field_C);
         break;
     case 32:
-        if (read_callback != NULL) {
+        if (db_is_mapped_entry(current_database, &de)) {
+            src = current_database->mapping + de.offset;
+            if (read_callback != NULL) {
+                remaining_size = de.length;
+                chunk_size = read_threshold - read_count;
+
+                while (remaining_size >= chunk_size) {
+                    memcpy(buf, src, chunk_size);
+                    buf += chunk_size;
+                    src += chunk_size;
+                    remaining_size -= chunk_size;
+
+                    read_count = 0;
+                    read_callback();
+
+                    chunk_size = read_threshold;
+                }
+
+                if (remaining_size != 0) {
+                    memcpy(buf, src, remaining_size);
+                    read_count += remaining_size;
+                }
+            } else {
+                memcpy(buf, src, de.length);
+            }
+        } else if (read_callback != NULL) {
             remaining_size = de.length;
             chunk_size = read_threshold - read_count;
 
@@ -649,6 +706,12 @@ DB_FILE* db_fopen(const char* filename, const char* mode)
         }
         break;
     case 32:
+        if (db_is_mapped_entry(current_database, &de)) {
+            // Serve stored entry directly from the mapping as in-memory
+            // stream. Such streams have their own read position and do not
+            // touch shared datafile stream.
+            return db_add_fp_rec(NULL, current_database->mapping + de.offset, de.length, flags | 0x10 | 0x8 | DB_FILE_MAPPED);
+        }
         return db_add_fp_rec(current_database->stream, NULL, de.length, flags | 0x20 | 0x8);
     case 64:
         buf = (unsigned char*)internal_malloc(0x4000);
@@ -1949,7 +2012,10 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
         return -1;
     }
 
+    database->mapping = compat_map_file(database->stream, &(database->mapping_size));
+
     if (assoc_init(&(database->root), 0, sizeof(*database->entries), NULL) != 0) {
+        db_unmap_database(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1957,6 +2023,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     }
 
     if (assoc_load(database->stream, &(database->root), 0) != 0) {
+        db_unmap_database(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1966,6 +2033,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     database->entries = (assoc_array*)internal_malloc(sizeof(*database->entries) * database->root.size);
     if (database->entries == NULL) {
         assoc_free(&(database->root));
+        db_unmap_database(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1994,6 +2062,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
 
         internal_free(database->entries);
         assoc_free(&(database->root));
+        db_unmap_database(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -2014,6 +2083,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     if (database->datafile_path == NULL) {
         internal_free(database->entries);
         assoc_free(&(database->root));
+        db_unmap_database(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -2027,6 +2097,10 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
         database->datafile_path[v2 + 1] = '\0';
     }
 
+    // The index is an optimization, lookups fall back to searching assoc
+    // arrays when it's not available.
+    db_init_path_index(database);
+
     return 0;
 }
 
@@ -2039,6 +2113,8 @@ static void db_exit_database(DB_DATABASE* database)
         return;
     }
 
+    db_unmap_database(database);
+
     if (database->stream != NULL) {
         fclose(database->stream);
         database->stream = NULL;
@@ -2049,6 +2125,8 @@ static void db_exit_database(DB_DATABASE* database)
         database->datafile = NULL;
     }
 
+    db_exit_path_index(database);
+
     if (database->entries != NULL) {
         for (index = 0; index < database->root.size; index++) {
             assoc_free(&(database->entries[index]));
@@ -2448,7 +2526,7 @@ static int db_delete_fp_rec(DB_FILE* stream)
     } else {
         switch (stream->flags & 0xF0) {
         case 16:
-            if (stream->field_1C != NULL) {
+            if (stream->field_1C != NULL && (stream->flags & DB_FILE_MAPPED) == 0) {
                 internal_free(stream->field_1C);
             }
             break;
@@ -2528,6 +2606,53 @@ static int db_find_dir_entry(char* path, dir_entry* de)
         pos--;
     }
 
+    if (current_database->path_index != NULL) {
+        const char* dir;
+        const char* name;
+        if (pos >= 0) {
+            normalized_path[pos] = '\0';
+            dir = normalized_path;
+            name = normalized_path + pos + 1;
+        } else {
+            // Paths without directory component are looked up in the first
+            // directory, see below.
+            if (current_database->root.size == 0) {
+                return -1;
+            }
+
+            dir = current_database->root.list[0].name;
+            name = normalized_path;
+        }
+
+        unsigned int hash = db_hash_path(dir, name);
+        unsigned int slot = hash & current_database->path_index_mask;
+        int rc = -1;
+        while (1) {
+            db_path_index_entry* index_entry = &(current_database->path_index[slot]);
+            if (index_entry->dir_index == -1) {
+                break;
+            }
+
+            if (index_entry->hash == hash) {
+                assoc_array* dir_entries = &(current_database->entries[index_entry->dir_index]);
+                if (compat_stricmp(name, dir_entries->list[index_entry->entry_index].name) == 0
+                    && compat_stricmp(dir, current_database->root.list[index_entry->dir_index].name) == 0) {
+                    *de = *((dir_entry*)dir_entries->list[index_entry->entry_index].data);
+                    rc = 0;
+                    break;
+                }
+            }
+
+            slot = (slot + 1) & current_database->path_index_mask;
+        }
+
+        if (pos >= 0) {
+            normalized_path[pos] = '\\';
+        }
+
+        return rc;
+    }
+
     if (pos >= 0) {
         normalized_path[pos] = '\0';
         dir_index = assoc_search(&(current_database->root), normalized_path);
@@ -2738,6 +2863,110 @@ static int fread_short(FILE* stream, unsigned short* s)
     return 0;
 }
 
+// Returns `true` if entry's data can be accessed directly via mapping.
+static bool db_is_mapped_entry(DB_DATABASE* database, dir_entry* de)
+{
+    if (database->mapping == NULL) {
+        return false;
+    }
+
+    if (de->offset < 0 || de->length < 0) {
+        return false;
+    }
+
+    return (size_t)de->offset + (size_t)de->length <= database->mapping_size;
+}
+
+static void db_unmap_database(DB_DATABASE* database)
+{
+    if (database->mapping != NULL) {
+        compat_unmap_file(database->mapping, database->mapping_size);
+        database->mapping = NULL;
+        database->mapping_size = 0;
+    }
+}
+
+// Builds index of all datafile entries by full path, so that
+// `db_find_dir_entry` can resolve path with a single hash probe instead of two
+// binary searches.
+static int db_init_path_index(DB_DATABASE* database)
+{
+    int length = 0;
+    for (int dir_index = 0; dir_index < database->root.size; dir_index++) {
+        length += database->entries[dir_index].size;
+    }
+
+    // Keep load factor below 50%.
+    unsigned int capacity = 16;
+    while (capacity < (unsigned int)length * 2) {
+        capacity *= 2;
+    }
+
+    database->path_index = (db_path_index_entry*)internal_malloc(sizeof(*database->path_index) * capacity);
+    if (database->path_index == NULL) {
+        return -1;
+    }
+
+    for (unsigned int slot = 0; slot < capacity; slot++) {
+        database->path_index[slot].dir_index = -1;
+    }
+
+    database->path_index_mask = capacity - 1;
+
+    for (int dir_index = 0; dir_index < database->root.size; dir_index++) {
+        const char* dir = database->root.list[dir_index].name;
+        assoc_array* dir_entries = &(database->entries[dir_index]);
+        for (int entry_index = 0; entry_index < dir_entries->size; entry_index++) {
+            unsigned int hash = db_hash_path(dir, dir_entries->list[entry_index].name);
+            unsigned int slot = hash & database->path_index_mask;
+            while (database->path_index[slot].dir_index != -1) {
+                slot = (slot + 1) & database->path_index_mask;
+            }
+
+            database->path_index[slot].hash = hash;
+            database->path_index[slot].dir_index = dir_index;
+            database->path_index[slot].entry_index = entry_index;
+        }
+    }
+
+    return 0;
+}
+
+static void db_exit_path_index(DB_DATABASE* database)
+{
+    if (database->path_index != NULL) {
+        internal_free(database->path_index);
+        database->path_index = NULL;
+    }
+
+    database->path_index_mask = 0;
+}
+
+// Case-insensitive FNV-1a hash of full path (`dir` and `name` joined with
+// backslash).
+static unsigned int db_hash_path(const char* dir, const char* name)
+{
+    unsigned int hash = 2166136261U;
+    const char* parts[2] = { dir, name };
+
+    for (int part = 0; part < 2; part++) {
+        if (part != 0) {
+            hash = (hash ^ '\\') * 16777619U;
+        }
+
+        for (const char* pch = parts[part]; *pch != '\0'; pch++) {
+            unsigned char ch = (unsigned char)*pch;
+            if (ch >= 'a' && ch <= 'z') {
+                ch -= 'a' - 'A';
+            }
+
+            hash = (hash ^ ch) * 16777619U;
+        }
+    }
+
+    return hash;
+}
+
 static inline bool fileFindIsDirectory(DB_FIND_DATA* findData)
 {
 #if defined(_WIN32)
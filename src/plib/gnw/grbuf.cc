@@ -2,10 +2,34 @@
 
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GRBUF_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GRBUF_NEON
+#endif
+
+#if defined(GRBUF_SSE2) || defined(GRBUF_NEON)
+#define GRBUF_VECTORIZED
+#endif
+
 #include "plib/color/color.h"
 
 namespace fallout {
 
+// Number of pixels processed at once by vectorized blitters.
+#define GRBUF_VECTOR_SIZE 16
+
+// Masks returned by [grbuf_zero_mask], bit is set for zero byte.
+#define GRBUF_ALL_ZERO 0xFFFF
+#define GRBUF_NONE_ZERO 0
+
+#ifdef GRBUF_VECTORIZED
+static unsigned int grbuf_zero_mask(const unsigned char* ptr);
+static void grbuf_blend(unsigned char* dest, const unsigned char* src, const unsigned char* mask);
+#endif
+
 // 0x4BD850
 void draw_line(unsigned char* buf, int pitch, int x1, int y1, int x2, int y2, int color)
 {
@@ -222,7 +246,23 @@ void mask_buf_to_buf(unsigned char* src, int width, int height, int srcPitch, un
     int x;
 
     for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++) {
+        x = 0;
+
+#ifdef GRBUF_VECTORIZED
+        for (; x + GRBUF_VECTOR_SIZE <= width; x += GRBUF_VECTOR_SIZE) {
+            unsigned int zeros = grbuf_zero_mask(mask);
+            if (zeros == GRBUF_NONE_ZERO) {
+                memcpy(dest, src, GRBUF_VECTOR_SIZE);
+            } else if (zeros != GRBUF_ALL_ZERO) {
+                grbuf_blend(dest, src, mask);
+            }
+            src += GRBUF_VECTOR_SIZE;
+            mask += GRBUF_VECTOR_SIZE;
+            dest += GRBUF_VECTOR_SIZE;
+        }
+#endif
+
+        for (; x < width; x++) {
             if (*mask != 0) {
                 *dest = *src;
             }
@@ -347,7 +387,22 @@ void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int sr
     int srcSkip = srcPitch - width;
 
     for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
+        int x = 0;
+
+#ifdef GRBUF_VECTORIZED
+        for (; x + GRBUF_VECTOR_SIZE <= width; x += GRBUF_VECTOR_SIZE) {
+            unsigned int zeros = grbuf_zero_mask(src);
+            if (zeros == GRBUF_NONE_ZERO) {
+                memcpy(dest, src, GRBUF_VECTOR_SIZE);
+            } else if (zeros != GRBUF_ALL_ZERO) {
+                grbuf_blend(dest, src, src);
+            }
+            src += GRBUF_VECTOR_SIZE;
+            dest += GRBUF_VECTOR_SIZE;
+        }
+#endif
+
+        for (; x < width; x++) {
             unsigned char c = *src++;
             if (c != 0) {
                 *dest = c;
@@ -359,4 +414,107 @@ void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int sr
     }
 }
 
+// Same as [trans_buf_to_buf], but every non-transparent pixel is translated
+// through `lut` (256 entries).
+void trans_lut_buf_to_buf(unsigned char* src, int width, int height, int srcPitch, unsigned char* dest, int destPitch, unsigned char* lut)
+{
+    int destSkip = destPitch - width;
+    int srcSkip = srcPitch - width;
+
+    for (int y = 0; y < height; y++) {
+        int x = 0;
+
+#ifdef GRBUF_VECTORIZED
+        for (; x + GRBUF_VECTOR_SIZE <= width; x += GRBUF_VECTOR_SIZE) {
+            unsigned int zeros = grbuf_zero_mask(src);
+            if (zeros != GRBUF_ALL_ZERO) {
+                unsigned char translated[GRBUF_VECTOR_SIZE];
+                for (int index = 0; index < GRBUF_VECTOR_SIZE; index++) {
+                    translated[index] = lut[src[index]];
+                }
+
+                if (zeros == GRBUF_NONE_ZERO) {
+                    memcpy(dest, translated, GRBUF_VECTOR_SIZE);
+                } else {
+                    grbuf_blend(dest, translated, src);
+                }
+            }
+            src += GRBUF_VECTOR_SIZE;
+            dest += GRBUF_VECTOR_SIZE;
+        }
+#endif
+
+        for (; x < width; x++) {
+            unsigned char c = *src++;
+            if (c != 0) {
+                *dest = lut[c];
+            }
+            dest++;
+        }
+        src += srcSkip;
+        dest += destSkip;
+    }
+}
+
+// Returns number of leading transparent (zero) pixels in `src`, up to
+// `length`.
+int buf_skip_transparent(unsigned char* src, int length)
+{
+    int x = 0;
+
+#ifdef GRBUF_VECTORIZED
+    for (; x + GRBUF_VECTOR_SIZE <= length; x += GRBUF_VECTOR_SIZE) {
+        if (grbuf_zero_mask(src + x) != GRBUF_ALL_ZERO) {
+            break;
+        }
+    }
+#endif
+
+    while (x < length && src[x] == 0) {
+        x++;
+    }
+
+    return x;
+}
+
+#ifdef GRBUF_VECTORIZED
+// Returns mask of zero bytes among [GRBUF_VECTOR_SIZE] bytes at `ptr`, bit
+// is set for zero byte.
+static unsigned int grbuf_zero_mask(const unsigned char* ptr)
+{
+#if defined(GRBUF_SSE2)
+    __m128i value = _mm_loadu_si128((const __m128i*)ptr);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128()));
+#elif defined(GRBUF_NEON)
+    uint8x16_t zeros = vceqzq_u8(vld1q_u8(ptr));
+    if (vminvq_u8(zeros) != 0) {
+        return GRBUF_ALL_ZERO;
+    }
+
+    if (vmaxvq_u8(zeros) == 0) {
+        return GRBUF_NONE_ZERO;
+    }
+
+    // Callers only need to know that the vector is mixed.
+    return 1;
+#endif
+}
+
+// Copies [GRBUF_VECTOR_SIZE] bytes from `src` to `dest` where `mask` is not
+// zero.
+static void grbuf_blend(unsigned char* dest, const unsigned char* src, const unsigned char* mask)
+{
+#if defined(GRBUF_SSE2)
+    __m128i zeros = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)mask), _mm_setzero_si128());
+    __m128i s = _mm_loadu_si128((const __m128i*)src);
+    __m128i d = _mm_loadu_si128((const __m128i*)dest);
+    d = _mm_or_si128(_mm_and_si128(zeros, d), _mm_andnot_si128(zeros, s));
+    _mm_storeu_si128((__m128i*)dest, d);
+#elif defined(GRBUF_NEON)
+    uint8x16_t zeros = vceqzq_u8(vld1q_u8(mask));
+    vst1q_u8(dest, vbslq_u8(zeros, vld1q_u8(dest), vld1q_u8(src)));
+#endif
+}
+#endif
+
 } // namespace fallout
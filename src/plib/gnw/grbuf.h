@@ -18,6 +18,8 @@ void swap_color_buf(unsigned char* buf, int width, int height, int pitch, int co
 void buf_outline(unsigned char* buf, int width, int height, int pitch, int a5);
 void srcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height);
 void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height);
+void trans_lut_buf_to_buf(unsigned char* src, int width, int height, int srcPitch, unsigned char* dest, int destPitch, unsigned char* lut);
+int buf_skip_transparent(unsigned char* src, int length);
 
 } // namespace fallout
 
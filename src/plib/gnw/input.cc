@@ -20,6 +20,10 @@
 
 namespace fallout {
 
+// Number of consecutive polls of the same interval after which virtual clock
+// is moved, see [elapsed_time].
+#define VIRTUAL_TIME_POLL_LIMIT 64
+
 typedef struct GNW95RepeatStruct {
     // Time when appropriate key was pressed down or -1 if it's up.
     unsigned int time;
@@ -122,6 +126,19 @@ static bool bk_disabled;
 // 0x671F08
 static unsigned int bk_process_time;
 
+// Offset added to [get_time] by [advance_time] while real clock is used.
+static unsigned int time_skew = 0;
+
+// Virtual clock used by fast-forward VCR playback instead of the real one (see
+// [set_time_virtual]).
+static bool time_virtual = false;
+static unsigned int virtual_time = 0;
+
+// Interval repeatedly polled with [elapsed_time] while virtual clock is used,
+// see [elapsed_time].
+static unsigned int virtual_time_poll_start;
+static int virtual_time_poll_count;
+
 // 0x4B32C0
 int GNW_input_init(int use_msec_timer)
 {
@@ -631,12 +648,49 @@ void register_screendump(int new_screendump_key, ScreenDumpFunc* new_screendump_
 // 0x4B3BB8
 unsigned int get_time()
 {
-    return SDL_GetTicks();
+    if (time_virtual) {
+        return virtual_time;
+    }
+
+    return SDL_GetTicks() + time_skew;
+}
+
+// Moves [get_time] forward by [ms] without waiting.
+void advance_time(unsigned int ms)
+{
+    if (time_virtual) {
+        virtual_time += ms;
+    } else {
+        time_skew += ms;
+    }
+}
+
+// Switches [get_time] to a counter which is only moved by [advance_time], so
+// that game timing does not depend on host speed. Switching back returns to
+// the real clock without any offset.
+void set_time_virtual(bool enabled)
+{
+    if (enabled) {
+        if (!time_virtual) {
+            virtual_time = get_time();
+            virtual_time_poll_count = 0;
+            time_virtual = true;
+        }
+    } else {
+        time_virtual = false;
+        time_skew = 0;
+    }
 }
 
 // 0x4B3BC4
 void pause_for_tocks(unsigned int delay)
 {
+    if (time_virtual) {
+        process_bk();
+        advance_time(delay);
+        return;
+    }
+
     // NOTE: Uninline.
     unsigned int start = get_time();
     unsigned int end = get_time();
@@ -656,7 +710,12 @@ void pause_for_tocks(unsigned int delay)
 // 0x4B3C00
 void block_for_tocks(unsigned int ms)
 {
-    unsigned int start = SDL_GetTicks();
+    if (time_virtual) {
+        advance_time(ms);
+        return;
+    }
+
+    unsigned int start = get_time();
     unsigned int diff;
     do {
         // NOTE: Uninline
@@ -667,7 +726,23 @@ void block_for_tocks(unsigned int ms)
 // 0x4B3C28
 unsigned int elapsed_time(unsigned int start)
 {
-    unsigned int end = SDL_GetTicks();
+    // Busy waits would never end with virtual clock, so it is moved by one
+    // tock when the same interval is polled over and over. This depends on
+    // calls only, so playback stays deterministic.
+    if (time_virtual) {
+        if (start == virtual_time_poll_start) {
+            virtual_time_poll_count++;
+            if (virtual_time_poll_count >= VIRTUAL_TIME_POLL_LIMIT) {
+                virtual_time++;
+                virtual_time_poll_count = 0;
+            }
+        } else {
+            virtual_time_poll_start = start;
+            virtual_time_poll_count = 0;
+        }
+    }
+
+    unsigned int end = get_time();
 
     // NOTE: Uninline.
     return elapsed_tocks(end, start);
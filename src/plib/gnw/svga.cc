@@ -1,14 +1,38 @@
 #include "plib/gnw/svga.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
 #include "plib/gnw/gnw.h"
 #include "plib/gnw/grbuf.h"
 #include "plib/gnw/mouse.h"
+#include "plib/gnw/vcr.h"
 #include "plib/gnw/winmain.h"
 
 namespace fallout {
 
+// Maximum number of separate dirty rects tracked between presents, the rest
+// are merged into existing ones.
+#define DIRTY_RECTS_CAPACITY 16
+
+// Span of a [gSdlSurface] row which contains pixels with palette indices in
+// [paletteSpansStart]..[paletteSpansEnd] range, `minX > maxX` when there are
+// none. Rows are rescanned lazily after being redrawn.
+typedef struct PaletteRowSpan {
+    int minX;
+    int maxX;
+    bool stale;
+} PaletteRowSpan;
+
 static bool createRenderer(int width, int height);
 static void destroyRenderer();
+static void renderUpdatePaletteLookup();
+static void renderConvertRect(const SDL_Rect* rect);
+static void renderQueueRect(const SDL_Rect* rect);
+static void renderQueuePaletteRects(int start, int count);
+static void renderScanPaletteRow(int y, PaletteRowSpan* span);
+static void renderMarkPaletteRowsStale(int y, int height);
+static int rectArea(const SDL_Rect* rect);
 
 // screen rect
 Rect scr_size;
@@ -25,6 +49,20 @@ SDL_Surface* gSdlTextureSurface = NULL;
 // TODO: Remove once migration to update-render cycle is completed.
 FpsLimiter sharedFpsLimiter;
 
+// Regions of [gSdlSurface] changed since last [renderPresent].
+static SDL_Rect dirtyRects[DIRTY_RECTS_CAPACITY];
+static int dirtyRectsLength = 0;
+
+// Current palette mapped to [gSdlTextureSurface] pixel format.
+static Uint32 paletteLookup[256];
+
+// Index of rows using palette range changed by last partial palette update
+// (typically color cycling), one entry per [gSdlSurface] row.
+static PaletteRowSpan* paletteRowSpans = NULL;
+static int paletteRowSpansLength = 0;
+static int paletteSpansStart = 0;
+static int paletteSpansEnd = 0;
+
 // 0x4CB310
 void GNW95_SetPaletteEntries(unsigned char* palette, int start, int count)
 {
@@ -41,7 +79,10 @@ void GNW95_SetPaletteEntries(unsigned char* palette, int start, int count)
         }
 
         SDL_SetPaletteColors(gSdlSurface->format->palette, colors, start, count);
-        SDL_BlitSurface(gSdlSurface, NULL, gSdlTextureSurface, NULL);
+        renderUpdatePaletteLookup();
+
+        // Only pixels using changed entries need to be converted again.
+        renderQueuePaletteRects(start, count);
     }
 }
 
@@ -59,7 +100,8 @@ void GNW95_SetPalette(unsigned char* palette)
         }
 
         SDL_SetPaletteColors(gSdlSurface->format->palette, colors, 0, 256);
-        SDL_BlitSurface(gSdlSurface, NULL, gSdlTextureSurface, NULL);
+        renderUpdatePaletteLookup();
+        renderQueueRect(NULL);
     }
 }
 
@@ -68,16 +110,13 @@ void GNW95_ShowRect(unsigned char* src, unsigned int srcPitch, unsigned int a3,
 {
     buf_to_buf(src + srcPitch * srcY + srcX, srcWidth, srcHeight, srcPitch, (unsigned char*)gSdlSurface->pixels + gSdlSurface->pitch * destY + destX, gSdlSurface->pitch);
 
-    SDL_Rect srcRect;
-    srcRect.x = destX;
-    srcRect.y = destY;
-    srcRect.w = srcWidth;
-    srcRect.h = srcHeight;
-
-    SDL_Rect destRect;
-    destRect.x = destX;
-    destRect.y = destY;
-    SDL_BlitSurface(gSdlSurface, &srcRect, gSdlTextureSurface, &destRect);
+    // Conversion to texture format is deferred to [renderPresent].
+    SDL_Rect rect;
+    rect.x = destX;
+    rect.y = destY;
+    rect.w = srcWidth;
+    rect.h = srcHeight;
+    renderAddDirtyRect(&rect);
 }
 
 bool svga_init(VideoOptions* video_options)
@@ -135,6 +174,7 @@ bool svga_init(VideoOptions* video_options)
     }
 
     SDL_SetPaletteColors(gSdlSurface->format->palette, colors, 0, 256);
+    renderUpdatePaletteLookup();
 
     scr_size.ulx = 0;
     scr_size.uly = 0;
@@ -152,6 +192,12 @@ void svga_exit()
 {
     destroyRenderer();
 
+    if (paletteRowSpans != NULL) {
+        free(paletteRowSpans);
+        paletteRowSpans = NULL;
+        paletteRowSpansLength = 0;
+    }
+
     if (gSdlWindow != NULL) {
         SDL_DestroyWindow(gSdlWindow);
         gSdlWindow = NULL;
@@ -198,6 +244,10 @@ static bool createRenderer(int width, int height)
         return false;
     }
 
+    // New texture is blank, it needs to be uploaded entirely.
+    renderUpdatePaletteLookup();
+    renderQueueRect(NULL);
+
     return true;
 }
 
@@ -225,12 +275,265 @@ void handleWindowSizeChanged()
     createRenderer(screenGetWidth(), screenGetHeight());
 }
 
+// Marks region of [gSdlSurface] as changed, `NULL` means entire screen.
+void renderAddDirtyRect(const SDL_Rect* rect)
+{
+    if (gSdlSurface == NULL) {
+        return;
+    }
+
+    if (rect != NULL) {
+        renderMarkPaletteRowsStale(rect->y, rect->h);
+    } else {
+        renderMarkPaletteRowsStale(0, gSdlSurface->h);
+    }
+
+    renderQueueRect(rect);
+}
+
+// Schedules region of [gSdlSurface] for conversion and upload on next
+// [renderPresent] without invalidating [paletteRowSpans].
+static void renderQueueRect(const SDL_Rect* rect)
+{
+    if (gSdlSurface == NULL) {
+        return;
+    }
+
+    SDL_Rect bounds;
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = gSdlSurface->w;
+    bounds.h = gSdlSurface->h;
+
+    SDL_Rect dirtyRect;
+    if (rect != NULL) {
+        if (!SDL_IntersectRect(rect, &bounds, &dirtyRect)) {
+            return;
+        }
+    } else {
+        dirtyRect = bounds;
+    }
+
+    // Merge with every rect it overlaps or when union does not waste more
+    // than it saves. Merged rect can now touch rects skipped earlier, so
+    // restart until nothing merges.
+    int index = 0;
+    while (index < dirtyRectsLength) {
+        SDL_Rect unionRect;
+        SDL_UnionRect(&(dirtyRects[index]), &dirtyRect, &unionRect);
+
+        if (rectArea(&unionRect) <= rectArea(&(dirtyRects[index])) + rectArea(&dirtyRect)) {
+            dirtyRect = unionRect;
+            dirtyRectsLength--;
+            dirtyRects[index] = dirtyRects[dirtyRectsLength];
+            index = 0;
+        } else {
+            index++;
+        }
+    }
+
+    if (dirtyRectsLength == DIRTY_RECTS_CAPACITY) {
+        // Merge into the rect which grows the least.
+        int bestIndex = 0;
+        int bestGrowth = INT_MAX;
+        for (index = 0; index < dirtyRectsLength; index++) {
+            SDL_Rect unionRect;
+            SDL_UnionRect(&(dirtyRects[index]), &dirtyRect, &unionRect);
+
+            int growth = rectArea(&unionRect) - rectArea(&(dirtyRects[index]));
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                bestIndex = index;
+            }
+        }
+
+        SDL_UnionRect(&(dirtyRects[bestIndex]), &dirtyRect, &(dirtyRects[bestIndex]));
+        return;
+    }
+
+    dirtyRects[dirtyRectsLength++] = dirtyRect;
+}
+
 void renderPresent()
 {
-    SDL_UpdateTexture(gSdlTexture, NULL, gSdlTextureSurface->pixels, gSdlTextureSurface->pitch);
+    // Texture still holds the last frame, nothing to do.
+    if (dirtyRectsLength == 0) {
+        return;
+    }
+
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_RENDER);
+
+    for (int index = 0; index < dirtyRectsLength; index++) {
+        SDL_Rect* rect = &(dirtyRects[index]);
+        renderConvertRect(rect);
+
+        unsigned char* pixels = (unsigned char*)gSdlTextureSurface->pixels
+            + gSdlTextureSurface->pitch * rect->y
+            + gSdlTextureSurface->format->BytesPerPixel * rect->x;
+        SDL_UpdateTexture(gSdlTexture, rect, pixels, gSdlTextureSurface->pitch);
+    }
+
+    dirtyRectsLength = 0;
+
     SDL_RenderClear(gSdlRenderer);
     SDL_RenderCopy(gSdlRenderer, gSdlTexture, NULL, NULL);
     SDL_RenderPresent(gSdlRenderer);
 }
 
+static void renderUpdatePaletteLookup()
+{
+    if (gSdlSurface == NULL || gSdlSurface->format->palette == NULL || gSdlTextureSurface == NULL) {
+        return;
+    }
+
+    SDL_Palette* palette = gSdlSurface->format->palette;
+    for (int index = 0; index < 256 && index < palette->ncolors; index++) {
+        SDL_Color* color = &(palette->colors[index]);
+        paletteLookup[index] = SDL_MapRGB(gSdlTextureSurface->format, color->r, color->g, color->b);
+    }
+}
+
+// Converts region of 8-bit [gSdlSurface] into [gSdlTextureSurface].
+static void renderConvertRect(const SDL_Rect* rect)
+{
+    if (gSdlTextureSurface->format->BytesPerPixel != 4) {
+        SDL_Rect srcRect = *rect;
+        SDL_Rect destRect = *rect;
+        SDL_BlitSurface(gSdlSurface, &srcRect, gSdlTextureSurface, &destRect);
+        return;
+    }
+
+    unsigned char* src = (unsigned char*)gSdlSurface->pixels + gSdlSurface->pitch * rect->y + rect->x;
+    unsigned char* dest = (unsigned char*)gSdlTextureSurface->pixels + gSdlTextureSurface->pitch * rect->y + rect->x * 4;
+
+    for (int y = 0; y < rect->h; y++) {
+        Uint32* destPixels = (Uint32*)dest;
+        for (int x = 0; x < rect->w; x++) {
+            destPixels[x] = paletteLookup[src[x]];
+        }
+
+        src += gSdlSurface->pitch;
+        dest += gSdlTextureSurface->pitch;
+    }
+}
+
+// Schedules conversion of rows which use palette entries in [start]..[start]
+// + [count] range.
+static void renderQueuePaletteRects(int start, int count)
+{
+    if (count >= 256) {
+        renderQueueRect(NULL);
+        return;
+    }
+
+    if (paletteRowSpansLength != gSdlSurface->h) {
+        PaletteRowSpan* spans = (PaletteRowSpan*)realloc(paletteRowSpans, sizeof(*spans) * gSdlSurface->h);
+        if (spans == NULL) {
+            renderQueueRect(NULL);
+            return;
+        }
+
+        paletteRowSpans = spans;
+        paletteRowSpansLength = gSdlSurface->h;
+        renderMarkPaletteRowsStale(0, paletteRowSpansLength);
+    }
+
+    if (start != paletteSpansStart || start + count != paletteSpansEnd) {
+        paletteSpansStart = start;
+        paletteSpansEnd = start + count;
+        renderMarkPaletteRowsStale(0, paletteRowSpansLength);
+    }
+
+    // Adjacent rows are grouped into bands to keep number of rects low.
+    SDL_Rect band;
+    bool hasBand = false;
+
+    for (int y = 0; y < paletteRowSpansLength; y++) {
+        PaletteRowSpan* span = &(paletteRowSpans[y]);
+        if (span->stale) {
+            renderScanPaletteRow(y, span);
+        }
+
+        if (span->minX > span->maxX) {
+            continue;
+        }
+
+        if (hasBand && band.y + band.h == y) {
+            int right = band.x + band.w;
+            if (span->minX < band.x) {
+                band.x = span->minX;
+            }
+            if (span->maxX + 1 > right) {
+                right = span->maxX + 1;
+            }
+            band.w = right - band.x;
+            band.h++;
+        } else {
+            if (hasBand) {
+                renderQueueRect(&band);
+            }
+
+            band.x = span->minX;
+            band.y = y;
+            band.w = span->maxX - span->minX + 1;
+            band.h = 1;
+            hasBand = true;
+        }
+    }
+
+    if (hasBand) {
+        renderQueueRect(&band);
+    }
+}
+
+static void renderScanPaletteRow(int y, PaletteRowSpan* span)
+{
+    unsigned char* src = (unsigned char*)gSdlSurface->pixels + gSdlSurface->pitch * y;
+    unsigned int start = paletteSpansStart;
+    unsigned int count = paletteSpansEnd - paletteSpansStart;
+    int width = gSdlSurface->w;
+
+    int x = 0;
+    while (x < width && src[x] - start >= count) {
+        x++;
+    }
+
+    span->stale = false;
+
+    if (x == width) {
+        span->minX = 0;
+        span->maxX = -1;
+        return;
+    }
+
+    span->minX = x;
+
+    x = width - 1;
+    while (src[x] - start >= count) {
+        x--;
+    }
+
+    span->maxX = x;
+}
+
+static void renderMarkPaletteRowsStale(int y, int height)
+{
+    int end = y + height;
+    if (y < 0) {
+        y = 0;
+    }
+    if (end > paletteRowSpansLength) {
+        end = paletteRowSpansLength;
+    }
+
+    for (; y < end; y++) {
+        paletteRowSpans[y].stale = true;
+    }
+}
+
+static int rectArea(const SDL_Rect* rect)
+{
+    return rect->w * rect->h;
+}
+
 } // namespace fallout
@@ -28,6 +28,7 @@ void svga_exit();
 int screenGetWidth();
 int screenGetHeight();
 void handleWindowSizeChanged();
+void renderAddDirtyRect(const SDL_Rect* rect);
 void renderPresent();
 
 } // namespace fallout
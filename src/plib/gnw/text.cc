@@ -7,6 +7,7 @@
 #include "plib/color/color.h"
 #include "plib/db/db.h"
 #include "plib/gnw/memory.h"
+#include "plib/gnw/vcr.h"
 
 namespace fallout {
 
@@ -17,6 +18,8 @@ namespace fallout {
 #define FONT_MANAGER_MAX 10
 
 static int load_font(int n);
+static void build_font_spans(Font* textFont, int dataSize);
+static int build_glyph_spans(const unsigned char* data, int width, int height, unsigned char* spans);
 static void GNW_text_font(int font_num);
 static bool text_font_exists(int font_num, FontMgrPtr* mgr);
 static void GNW_text_to_buf(unsigned char* buf, const char* str, int swidth, int fullw, int color);
@@ -122,6 +125,11 @@ void GNW_text_exit()
         if (font[i].num != 0) {
             mem_free(font[i].info);
             mem_free(font[i].data);
+
+            if (font[i].spans != NULL) {
+                mem_free(font[i].spans);
+                mem_free(font[i].spanOffsets);
+            }
         }
     }
 }
@@ -139,6 +147,8 @@ static int load_font(int n)
     Font* textFontDescriptor = &(font[n]);
     textFontDescriptor->data = NULL;
     textFontDescriptor->info = NULL;
+    textFontDescriptor->spans = NULL;
+    textFontDescriptor->spanOffsets = NULL;
 
     DB_FILE* stream = db_fopen(path, "rb");
     int dataSize;
@@ -178,6 +188,8 @@ static int load_font(int n)
         goto out;
     }
 
+    build_font_spans(textFontDescriptor, dataSize);
+
     rc = 0;
 
 out:
@@ -201,6 +213,89 @@ out:
     return rc;
 }
 
+// Expands 1-bit glyph data of `textFont` into runs of set pixels, so that
+// [GNW_text_to_buf] draws every run with one `memset` instead of testing
+// pixels bit by bit. Font is left without spans if it cannot be expanded,
+// including when glyphs are out of data bounds.
+static void build_font_spans(Font* textFont, int dataSize)
+{
+    for (int index = 0; index < textFont->num; index++) {
+        FontInfo* glyph = &(textFont->info[index]);
+        if (glyph->width < 0 || glyph->width > 255 || glyph->offset < 0) {
+            return;
+        }
+
+        if (glyph->offset + ((glyph->width + 7) >> 3) * textFont->height > dataSize) {
+            return;
+        }
+    }
+
+    textFont->spanOffsets = (int*)mem_malloc(sizeof(*textFont->spanOffsets) * textFont->num);
+    if (textFont->spanOffsets == NULL) {
+        return;
+    }
+
+    int size = 0;
+    for (int index = 0; index < textFont->num; index++) {
+        FontInfo* glyph = &(textFont->info[index]);
+        textFont->spanOffsets[index] = size;
+        size += build_glyph_spans(textFont->data + glyph->offset, glyph->width, textFont->height, NULL);
+    }
+
+    textFont->spans = (unsigned char*)mem_malloc(size);
+    if (textFont->spans == NULL) {
+        mem_free(textFont->spanOffsets);
+        textFont->spanOffsets = NULL;
+        return;
+    }
+
+    for (int index = 0; index < textFont->num; index++) {
+        FontInfo* glyph = &(textFont->info[index]);
+        build_glyph_spans(textFont->data + glyph->offset, glyph->width, textFont->height, textFont->spans + textFont->spanOffsets[index]);
+    }
+}
+
+// Every glyph row is stored as number of runs followed by offset and length of
+// each run. Returns size of glyph spans, `spans` can be `NULL` to measure it.
+static int build_glyph_spans(const unsigned char* data, int width, int height, unsigned char* spans)
+{
+    int pitch = (width + 7) >> 3;
+    int size = 0;
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = data + pitch * y;
+        int countOffset = size++;
+        int count = 0;
+
+        int x = 0;
+        while (x < width) {
+            if ((row[x >> 3] & (0x80 >> (x & 7))) == 0) {
+                x++;
+                continue;
+            }
+
+            int start = x;
+            while (x < width && (row[x >> 3] & (0x80 >> (x & 7))) != 0) {
+                x++;
+            }
+
+            if (spans != NULL) {
+                spans[size] = start;
+                spans[size + 1] = x - start;
+            }
+
+            size += 2;
+            count++;
+        }
+
+        if (spans != NULL) {
+            spans[countOffset] = count;
+        }
+    }
+
+    return size;
+}
+
 // 0x4C1840
 int text_add_manager(FontMgrPtr mgr)
 {
@@ -308,6 +403,8 @@ static bool text_font_exists(int font_num, FontMgrPtr* mgr)
 // 0x4C1A70
 void GNW_text_to_buf(unsigned char* buf, const char* str, int swidth, int fullw, int color)
 {
+    VcrProfileScope profileScope(VCR_PROFILE_SECTION_TEXT);
+
     if ((color & FONT_SHADOW) != 0) {
         color &= ~FONT_SHADOW;
         text_to_buf(buf + fullw + 1, str, swidth, fullw, colorTable[0]);
@@ -336,6 +433,21 @@ void GNW_text_to_buf(unsigned char* buf, const char* str, int swidth, int fullw,
                 break;
             }
 
+            if (curr_font->spans != NULL && (ch & 0xFF) < curr_font->num) {
+                unsigned char* spans = curr_font->spans + curr_font->spanOffsets[ch & 0xFF];
+                for (int y = 0; y < curr_font->height; y++) {
+                    int count = *spans++;
+                    for (int index = 0; index < count; index++) {
+                        memset(ptr + spans[0], color & 0xFF, spans[1]);
+                        spans += 2;
+                    }
+                    ptr += fullw;
+                }
+
+                ptr = end;
+                continue;
+            }
+
             unsigned char* glyphData = curr_font->data + glyph->offset;
             for (int y = 0; y < curr_font->height; y++) {
                 int bits = 0x80;
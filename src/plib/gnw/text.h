@@ -53,6 +53,13 @@ typedef struct Font {
 
     FontInfo* info;
     unsigned char* data;
+
+    // CE: Glyph rows expanded into runs of set pixels (see [build_font_spans]),
+    // `NULL` if font is drawn bit by bit.
+    unsigned char* spans;
+
+    // Offsets of glyphs into [spans].
+    int* spanOffsets;
 } Font;
 
 extern text_to_buf_func* text_to_buf;
@@ -2,15 +2,25 @@
 
 #include <stdlib.h>
 
+#include <SDL.h>
+
+#include "plib/gnw/debug.h"
 #include "plib/gnw/input.h"
 #include "plib/gnw/memory.h"
+#include "plib/gnw/svga.h"
 
 namespace fallout {
 
+// Maximum nesting of [VcrProfileScope]s.
+#define VCR_PROFILE_STACK_SIZE 32
+
 static bool vcr_create_buffer();
 static bool vcr_destroy_buffer();
 static bool vcr_clear_buffer();
 static bool vcr_load_buffer();
+static void vcr_profile_reset();
+static void vcr_profile_frame();
+static void vcr_profile_dump();
 
 // 0x51E2F0
 VcrEntry* vcr_buffer = NULL;
@@ -58,6 +68,32 @@ static int vcr_old_layout = 0;
 // 0x6AD940
 static VcrEntry vcr_last_play_event;
 
+// When set playback runs on virtual clock (see [set_time_virtual]) which is
+// moved to recorded time of every frame instead of waiting for it, and runs
+// unthrottled while gathering per-frame timings.
+static bool vcr_fast_forward = false;
+
+// Set while fast-forward playback gathers timings.
+static bool vcr_profiling = false;
+
+// Performance counter values of current frame sections.
+static Uint64 vcr_profile_current[VCR_PROFILE_SECTION_COUNT];
+
+// Sections of currently open [VcrProfileScope]s, innermost last. Only the
+// innermost one accumulates time, see [vcr_profile_begin].
+static int vcr_profile_stack[VCR_PROFILE_STACK_SIZE];
+static int vcr_profile_depth = 0;
+static Uint64 vcr_profile_last;
+
+// Sum and worst frame of each section over entire playback.
+static Uint64 vcr_profile_total[VCR_PROFILE_SECTION_COUNT];
+static Uint64 vcr_profile_max[VCR_PROFILE_SECTION_COUNT];
+
+static Uint64 vcr_frame_start;
+static Uint64 vcr_frame_total;
+static Uint64 vcr_frame_max;
+static unsigned int vcr_frame_count;
+
 // 0x4D2680
 bool vcr_record(const char* fileName)
 {
@@ -148,11 +184,22 @@ bool vcr_play(const char* fileName, unsigned int terminationFlags, VcrPlaybackCo
     vcr_terminate_flags = 0;
     vcr_counter = 0;
     vcr_time = 0;
+
+    if (vcr_fast_forward) {
+        set_time_virtual(true);
+    }
+
     vcr_start_time = get_time();
     vcr_state = VCR_STATE_PLAYING;
     vcr_last_play_event.time = 0;
     vcr_last_play_event.counter = 0;
 
+    if (vcr_fast_forward) {
+        vcr_profile_reset();
+        vcr_profiling = true;
+        sharedFpsLimiter.setEnabled(false);
+    }
+
     return true;
 }
 
@@ -163,6 +210,11 @@ void vcr_stop()
         vcr_state |= VCR_STATE_STOP_REQUESTED;
     }
 
+    // Clock offsets of fast-forward playback must not outlive it.
+    if (vcr_fast_forward) {
+        set_time_virtual(false);
+    }
+
     kb_clear();
 }
 
@@ -198,6 +250,12 @@ int vcr_update()
 
             kb_set_layout(vcr_old_layout);
 
+            if (vcr_profiling) {
+                vcr_profile_dump();
+                vcr_profiling = false;
+                sharedFpsLimiter.setEnabled(true);
+            }
+
             if (vcr_notify_callback != NULL) {
                 vcr_notify_callback(vcr_terminated_condition);
             }
@@ -216,6 +274,10 @@ int vcr_update()
         }
         break;
     case VCR_STATE_PLAYING:
+        if (vcr_profiling) {
+            vcr_profile_frame();
+        }
+
         if (vcr_buffer_index < vcr_buffer_end || vcr_load_buffer()) {
             VcrEntry* vcrEntry = &(vcr_buffer[vcr_buffer_index]);
             if (vcr_last_play_event.counter < vcrEntry->counter) {
@@ -225,7 +287,16 @@ int vcr_update()
                         * (vcrEntry->time - vcr_last_play_event.time)
                         / (vcrEntry->counter - vcr_last_play_event.counter);
 
-                    while (elapsed_time(vcr_start_time) < delay) {
+                    if (vcr_fast_forward) {
+                        // Virtual clock is only moved here, so every frame
+                        // sees interpolated recorded time.
+                        unsigned int now = get_time();
+                        if (now < vcr_start_time + delay) {
+                            advance_time(vcr_start_time + delay - now);
+                        }
+                    } else {
+                        while (elapsed_time(vcr_start_time) < delay) {
+                        }
                     }
                 }
             }
@@ -435,4 +506,127 @@ bool vcr_load_record(VcrEntry* vcrEntry, DB_FILE* stream)
     return false;
 }
 
+// Enables fast-forward mode for subsequent [vcr_play]. Meant to be used as
+// a repeatable benchmark, possibly with SDL dummy video and audio drivers.
+void vcr_set_fast_forward(bool fastForward)
+{
+    vcr_fast_forward = fastForward;
+}
+
+// Opens `section`, time spent in enclosing section so far is charged to it
+// and it is paused until matching [vcr_profile_end]. Returns `false` if
+// section is not timed.
+bool vcr_profile_begin(int section)
+{
+    if (!vcr_profiling || vcr_profile_depth >= VCR_PROFILE_STACK_SIZE) {
+        return false;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (vcr_profile_depth > 0) {
+        vcr_profile_current[vcr_profile_stack[vcr_profile_depth - 1]] += now - vcr_profile_last;
+    }
+
+    vcr_profile_stack[vcr_profile_depth++] = section;
+    vcr_profile_last = now;
+
+    return true;
+}
+
+// Closes innermost section and resumes enclosing one.
+void vcr_profile_end()
+{
+    if (vcr_profile_depth == 0) {
+        return;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (vcr_profiling) {
+        vcr_profile_current[vcr_profile_stack[vcr_profile_depth - 1]] += now - vcr_profile_last;
+    }
+
+    vcr_profile_depth--;
+    vcr_profile_last = now;
+}
+
+static void vcr_profile_reset()
+{
+    for (int section = 0; section < VCR_PROFILE_SECTION_COUNT; section++) {
+        vcr_profile_current[section] = 0;
+        vcr_profile_total[section] = 0;
+        vcr_profile_max[section] = 0;
+    }
+
+    vcr_frame_start = 0;
+    vcr_frame_total = 0;
+    vcr_frame_max = 0;
+    vcr_frame_count = 0;
+}
+
+// Closes current frame, playback advances one frame per [vcr_update].
+static void vcr_profile_frame()
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (vcr_profile_depth > 0) {
+        vcr_profile_current[vcr_profile_stack[vcr_profile_depth - 1]] += now - vcr_profile_last;
+    }
+
+    if (vcr_frame_start != 0) {
+        Uint64 frameTime = now - vcr_frame_start;
+        vcr_frame_total += frameTime;
+        if (frameTime > vcr_frame_max) {
+            vcr_frame_max = frameTime;
+        }
+        vcr_frame_count++;
+
+        for (int section = 0; section < VCR_PROFILE_SECTION_COUNT; section++) {
+            vcr_profile_total[section] += vcr_profile_current[section];
+            if (vcr_profile_current[section] > vcr_profile_max[section]) {
+                vcr_profile_max[section] = vcr_profile_current[section];
+            }
+        }
+    }
+
+    for (int section = 0; section < VCR_PROFILE_SECTION_COUNT; section++) {
+        vcr_profile_current[section] = 0;
+    }
+
+    // Open sections continue in the new frame.
+    vcr_profile_last = now;
+    vcr_frame_start = now;
+}
+
+static void vcr_profile_dump()
+{
+    static const char* names[VCR_PROFILE_SECTION_COUNT] = {
+        "render",
+        "script",
+        "ai",
+        "pathfinding",
+        "floor",
+        "text",
+    };
+
+    if (vcr_frame_count == 0) {
+        return;
+    }
+
+    double ms = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    debug_printf("\nVCR: %u frames, %.3f ms total, %.3f ms avg, %.3f ms max\n",
+        vcr_frame_count,
+        vcr_frame_total * ms,
+        vcr_frame_total * ms / vcr_frame_count,
+        vcr_frame_max * ms);
+
+    for (int section = 0; section < VCR_PROFILE_SECTION_COUNT; section++) {
+        debug_printf("VCR: %-12s %.3f ms total, %.3f ms avg, %.3f ms max\n",
+            names[section],
+            vcr_profile_total[section] * ms,
+            vcr_profile_total[section] * ms / vcr_frame_count,
+            vcr_profile_max[section] * ms);
+    }
+}
+
 } // namespace fallout
@@ -64,6 +64,17 @@ typedef struct VcrEntry {
     };
 } VcrEntry;
 
+// Sections timed during fast-forward playback (see [vcr_set_fast_forward]).
+typedef enum VcrProfileSection {
+    VCR_PROFILE_SECTION_RENDER,
+    VCR_PROFILE_SECTION_SCRIPT,
+    VCR_PROFILE_SECTION_AI,
+    VCR_PROFILE_SECTION_PATHFINDING,
+    VCR_PROFILE_SECTION_FLOOR,
+    VCR_PROFILE_SECTION_TEXT,
+    VCR_PROFILE_SECTION_COUNT,
+} VcrProfileSection;
+
 typedef void(VcrPlaybackCompletionCallback)(int reason);
 
 extern VcrEntry* vcr_buffer;
@@ -82,6 +93,30 @@ int vcr_update();
 bool vcr_dump_buffer();
 bool vcr_save_record(VcrEntry* ptr, DB_FILE* stream);
 bool vcr_load_record(VcrEntry* ptr, DB_FILE* stream);
+void vcr_set_fast_forward(bool fastForward);
+bool vcr_profile_begin(int section);
+void vcr_profile_end();
+
+// Adds time spent in the enclosing scope to given [VcrProfileSection] of
+// current playback frame. Time is exclusive, nested scopes pause the
+// enclosing one.
+class VcrProfileScope {
+public:
+    VcrProfileScope(int section)
+        : _started(vcr_profile_begin(section))
+    {
+    }
+
+    ~VcrProfileScope()
+    {
+        if (_started) {
+            vcr_profile_end();
+        }
+    }
+
+private:
+    const bool _started;
+};
 
 } // namespace fallout
 